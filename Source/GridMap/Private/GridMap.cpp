@@ -1,9 +1,15 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "GridMap.h"
+#include "GridMapStats.h"
 
 #define LOCTEXT_NAMESPACE "FGridMapModule"
 
+DEFINE_STAT(STAT_GridMap_CellQueries);
+DEFINE_STAT(STAT_GridMap_TilesResolved);
+DEFINE_STAT(STAT_GridMap_TilesChanged);
+DEFINE_STAT(STAT_GridMap_TilesUnchangedMask);
+
 void FGridMapModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridMapChunkActor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GridMapData.h"
+#include "GridMapStaticMeshActor.h"
+
+AGridMapChunkActor::AGridMapChunkActor(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, ChunkCoord(FIntVector::ZeroValue)
+	, CellSize(100)
+	, CellHeight(0)
+{
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+}
+
+void AGridMapChunkActor::PostLoad()
+{
+	Super::PostLoad();
+
+	// chunks saved before the tile components had their collision settings still have the engine's defaults
+	for (const FGridMapChunkMeshInstances& Entry : MeshInstances)
+	{
+		if (Entry.Component)
+		{
+			Entry.Component->ConditionalPostLoad();
+			SetTileCollision(Entry.Component);
+		}
+	}
+}
+
+void AGridMapChunkActor::InitChunk(const FIntVector& InChunkCoord, int32 InCellSize, int32 InCellHeight)
+{
+	ChunkCoord = InChunkCoord;
+	CellSize = InCellSize;
+	CellHeight = InCellHeight;
+
+	const FVector ChunkOrigin(ChunkCoord.X * UGridMapData::ChunkSize * CellSize, ChunkCoord.Y * UGridMapData::ChunkSize * CellSize, ChunkCoord.Z * GetCellHeight());
+	SetActorLocation(ChunkOrigin);
+}
+
+void AGridMapChunkActor::SetTile(const FIntVector& Cell, UGridMapTileSet* TileSet, UStaticMesh* StaticMesh, const FRotator& Rotation)
+{
+	if (StaticMesh == nullptr)
+	{
+		RemoveTile(Cell);
+		return;
+	}
+
+	const FTransform CellTransform = GetCellTransform(Cell, Rotation);
+	Modify();
+
+	// same mesh, we can just move the existing instance
+	if (FGridMapChunkTile* ExistingTile = Tiles.Find(Cell))
+	{
+		if (ExistingTile->Component && ExistingTile->Component->GetStaticMesh() == StaticMesh)
+		{
+			ExistingTile->TileSet = TileSet;
+			ExistingTile->Component->Modify();
+			ExistingTile->Component->UpdateInstanceTransform(ExistingTile->InstanceIndex, CellTransform, true, true, true);
+			return;
+		}
+
+		RemoveTile(Cell);
+	}
+
+	FGridMapChunkMeshInstances& Instances = FindOrAddMeshInstances(StaticMesh);
+	Instances.Component->Modify();
+
+	FGridMapChunkTile& NewTile = Tiles.Add(Cell);
+	NewTile.TileSet = TileSet;
+	NewTile.Component = Instances.Component;
+	NewTile.InstanceIndex = Instances.Component->AddInstance(CellTransform, true);
+	check(NewTile.InstanceIndex == Instances.InstanceCells.Num());
+	Instances.InstanceCells.Add(Cell);
+}
+
+bool AGridMapChunkActor::RemoveTile(const FIntVector& Cell)
+{
+	if (!Tiles.Contains(Cell))
+		return false;
+
+	Modify();
+
+	FGridMapChunkTile RemovedTile;
+	Tiles.RemoveAndCopyValue(Cell, RemovedTile);
+
+	FGridMapChunkMeshInstances* Instances = FindMeshInstances(RemovedTile.Component);
+	if (Instances == nullptr)
+		return true;
+
+	Instances->Component->Modify();
+
+	// move the last instance into the removed slot, so only the last
+	// instance is ever removed and no other indices shift
+	const int32 LastIndex = Instances->InstanceCells.Num() - 1;
+	if (RemovedTile.InstanceIndex != LastIndex)
+	{
+		FTransform LastTransform;
+		Instances->Component->GetInstanceTransform(LastIndex, LastTransform, true);
+		Instances->Component->UpdateInstanceTransform(RemovedTile.InstanceIndex, LastTransform, true, true, true);
+
+		const FIntVector MovedCell = Instances->InstanceCells[LastIndex];
+		Instances->InstanceCells[RemovedTile.InstanceIndex] = MovedCell;
+		Tiles.FindChecked(MovedCell).InstanceIndex = RemovedTile.InstanceIndex;
+	}
+
+	Instances->Component->RemoveInstance(LastIndex);
+	Instances->InstanceCells.Pop();
+
+	// no more instances of this mesh, get rid of the component
+	if (Instances->InstanceCells.Num() == 0)
+	{
+		UHierarchicalInstancedStaticMeshComponent* Component = Instances->Component;
+		MeshInstances.RemoveAllSwap([Component](const FGridMapChunkMeshInstances& Entry) { return Entry.Component == Component; });
+		RemoveInstanceComponent(Component);
+		Component->DestroyComponent();
+	}
+
+	return true;
+}
+
+const FGridMapChunkTile* AGridMapChunkActor::FindTile(const FIntVector& Cell) const
+{
+	return Tiles.Find(Cell);
+}
+
+UStaticMesh* AGridMapChunkActor::GetTileMesh(const FIntVector& Cell) const
+{
+	const FGridMapChunkTile* Tile = Tiles.Find(Cell);
+	return (Tile && Tile->Component) ? Tile->Component->GetStaticMesh() : nullptr;
+}
+
+FRotator AGridMapChunkActor::GetTileRotation(const FIntVector& Cell) const
+{
+	const FGridMapChunkTile* Tile = Tiles.Find(Cell);
+	if (Tile == nullptr || Tile->Component == nullptr)
+		return FRotator::ZeroRotator;
+
+	FTransform InstanceTransform;
+	Tile->Component->GetInstanceTransform(Tile->InstanceIndex, InstanceTransform, true);
+	return InstanceTransform.Rotator();
+}
+
+FTransform AGridMapChunkActor::GetCellTransform(const FIntVector& Cell, const FRotator& Rotation) const
+{
+	const FVector CellLocation(Cell.X * CellSize, Cell.Y * CellSize, Cell.Z * GetCellHeight());
+	return FTransform(Rotation.Quaternion(), CellLocation, FVector::OneVector);
+}
+
+FGridMapChunkMeshInstances* AGridMapChunkActor::FindMeshInstances(const UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	return MeshInstances.FindByPredicate([Component](const FGridMapChunkMeshInstances& Entry) { return Entry.Component == Component; });
+}
+
+FGridMapChunkMeshInstances& AGridMapChunkActor::FindOrAddMeshInstances(UStaticMesh* StaticMesh)
+{
+	for (FGridMapChunkMeshInstances& Entry : MeshInstances)
+	{
+		if (Entry.Component && Entry.Component->GetStaticMesh() == StaticMesh)
+			return Entry;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, NAME_None, RF_Transactional);
+	Component->SetMobility(EComponentMobility::Static);
+	Component->SetStaticMesh(StaticMesh);
+	SetTileCollision(Component);
+	Component->SetupAttachment(RootComponent);
+	AddInstanceComponent(Component);
+	Component->RegisterComponent();
+
+	FGridMapChunkMeshInstances& Entry = MeshInstances.AddDefaulted_GetRef();
+	Entry.Component = Component;
+	return Entry;
+}
+
+void AGridMapChunkActor::SetTileCollision(UHierarchicalInstancedStaticMeshComponent* Component)
+{
+	Component->SetGenerateOverlapEvents(false);
+	Component->SetCollisionObjectType(AGridMapStaticMeshActor::GetTileObjectType());
+}
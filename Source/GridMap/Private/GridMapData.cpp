@@ -0,0 +1,249 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridMapData.h"
+#include "TileSet.h"
+
+FIntVector UGridMapData::CellToChunk(const FIntVector& Cell)
+{
+	// integer division rounds towards zero, so negative cells are shifted down a chunk first
+	return FIntVector(
+		(Cell.X - (Cell.X < 0 ? ChunkSize - 1 : 0)) / ChunkSize,
+		(Cell.Y - (Cell.Y < 0 ? ChunkSize - 1 : 0)) / ChunkSize,
+		Cell.Z);
+}
+
+int32 UGridMapData::CellToChunkIndex(const FIntVector& Cell)
+{
+	const FIntVector ChunkCoord = CellToChunk(Cell);
+	return (Cell.X - ChunkCoord.X * ChunkSize) + (Cell.Y - ChunkCoord.Y * ChunkSize) * ChunkSize;
+}
+
+FIntVector UGridMapData::ChunkIndexToCell(const FIntVector& ChunkCoord, int32 ChunkIndex)
+{
+	return FIntVector(ChunkCoord.X * ChunkSize + ChunkIndex % ChunkSize, ChunkCoord.Y * ChunkSize + ChunkIndex / ChunkSize, ChunkCoord.Z);
+}
+
+UGridMapTileSet* UGridMapData::GetTileSet(const FIntVector& Cell) const
+{
+	const FGridMapDataChunk* Chunk = FindChunk(CellToChunk(Cell));
+	return Chunk ? GetTileSetById(Chunk->TileSetIds[CellToChunkIndex(Cell)]) : nullptr;
+}
+
+bool UGridMapData::GetCell(const FIntVector& Cell, FGridMapCell& OutCell) const
+{
+	const FGridMapDataChunk* Chunk = FindChunk(CellToChunk(Cell));
+	if (Chunk == nullptr)
+		return false;
+
+	const int32 ChunkIndex = CellToChunkIndex(Cell);
+	OutCell.TileSet = GetTileSetById(Chunk->TileSetIds[ChunkIndex]);
+	if (OutCell.TileSet == nullptr)
+		return false;
+
+	const bool bResolved = Chunk->TileLists[ChunkIndex] != Unresolved;
+	OutCell.TileList = bResolved ? Chunk->TileLists[ChunkIndex] : INDEX_NONE;
+	OutCell.Variant = bResolved ? Chunk->Variants[ChunkIndex] : INDEX_NONE;
+	OutCell.Mask = Chunk->Masks[ChunkIndex];
+	return true;
+}
+
+void UGridMapData::SetTileSet(const FIntVector& Cell, UGridMapTileSet* TileSet)
+{
+	const FIntVector ChunkCoord = CellToChunk(Cell);
+	const int32 ChunkIndex = CellToChunkIndex(Cell);
+
+	if (TileSet == nullptr)
+	{
+		FGridMapDataChunk* Chunk = FindChunk(ChunkCoord);
+		if (Chunk == nullptr || Chunk->TileSetIds[ChunkIndex] == 0)
+			return;
+
+		Chunk->TileSetIds[ChunkIndex] = 0;
+		Chunk->TileLists[ChunkIndex] = Unresolved;
+		--NumTiles;
+		if (--Chunk->NumTiles == 0)
+		{
+			RemoveChunk(ChunkCoord);
+		}
+		MarkPackageDirty();
+		return;
+	}
+
+	const uint16 TileSetId = FindOrAddTileSetId(TileSet);
+	FGridMapDataChunk& Chunk = FindOrAddChunk(ChunkCoord);
+	if (Chunk.TileSetIds[ChunkIndex] == TileSetId)
+		return;
+
+	if (Chunk.TileSetIds[ChunkIndex] == 0)
+	{
+		++Chunk.NumTiles;
+		++NumTiles;
+	}
+	Chunk.TileSetIds[ChunkIndex] = TileSetId;
+	Chunk.TileLists[ChunkIndex] = Unresolved;
+	MarkPackageDirty();
+}
+
+void UGridMapData::SetResolved(const FIntVector& Cell, int32 TileList, int32 Variant, uint8 Mask)
+{
+	FGridMapDataChunk* Chunk = FindChunk(CellToChunk(Cell));
+	if (Chunk == nullptr)
+		return;
+
+	const int32 ChunkIndex = CellToChunkIndex(Cell);
+	if (Chunk->TileSetIds[ChunkIndex] == 0)
+		return;
+
+	// lists and variants past what fits are simply left unresolved
+	const uint8 NewTileList = TileList >= 0 && TileList < Unresolved ? (uint8)TileList : Unresolved;
+	const uint8 NewVariant = (uint8)FMath::Clamp(Variant, 0, 255);
+	if (Chunk->TileLists[ChunkIndex] == NewTileList && Chunk->Variants[ChunkIndex] == NewVariant && Chunk->Masks[ChunkIndex] == Mask)
+		return;
+
+	Chunk->TileLists[ChunkIndex] = NewTileList;
+	Chunk->Variants[ChunkIndex] = NewVariant;
+	Chunk->Masks[ChunkIndex] = Mask;
+	MarkPackageDirty();
+}
+
+const FGridMapDataChunk* UGridMapData::FindChunk(const FIntVector& ChunkCoord) const
+{
+	const int32* ChunkIndex = ChunkIndexByCoord.Find(ChunkCoord);
+	return ChunkIndex ? &Chunks[*ChunkIndex] : nullptr;
+}
+
+FGridMapDataChunk* UGridMapData::FindChunk(const FIntVector& ChunkCoord)
+{
+	const int32* ChunkIndex = ChunkIndexByCoord.Find(ChunkCoord);
+	return ChunkIndex ? &Chunks[*ChunkIndex] : nullptr;
+}
+
+FGridMapDataChunk& UGridMapData::FindOrAddChunk(const FIntVector& ChunkCoord)
+{
+	if (FGridMapDataChunk* Chunk = FindChunk(ChunkCoord))
+		return *Chunk;
+
+	ChunkIndexByCoord.Add(ChunkCoord, Chunks.Num());
+
+	FGridMapDataChunk& Chunk = Chunks.AddDefaulted_GetRef();
+	Chunk.ChunkCoord = ChunkCoord;
+	Chunk.TileSetIds.SetNumZeroed(CellsPerChunk);
+	Chunk.TileLists.Init(Unresolved, CellsPerChunk);
+	Chunk.Variants.SetNumZeroed(CellsPerChunk);
+	Chunk.Masks.SetNumZeroed(CellsPerChunk);
+	return Chunk;
+}
+
+void UGridMapData::RemoveChunk(const FIntVector& ChunkCoord)
+{
+	int32 ChunkIndex;
+	if (!ChunkIndexByCoord.RemoveAndCopyValue(ChunkCoord, ChunkIndex))
+		return;
+
+	// the last chunk takes its place
+	Chunks.RemoveAtSwap(ChunkIndex);
+	if (Chunks.IsValidIndex(ChunkIndex))
+	{
+		ChunkIndexByCoord.Add(Chunks[ChunkIndex].ChunkCoord, ChunkIndex);
+	}
+}
+
+uint16 UGridMapData::FindOrAddTileSetId(UGridMapTileSet* TileSet)
+{
+	int32 TileSetIndex = TileSets.Find(TileSet);
+	if (TileSetIndex == INDEX_NONE)
+	{
+		TileSetIndex = TileSets.Add(TileSet);
+		TileSetRevisions.SetNum(TileSets.Num());
+		TileSetRevisions[TileSetIndex] = TileSet ? TileSet->TilesRevision : FGuid();
+	}
+	return (uint16)(TileSetIndex + 1);
+}
+
+void UGridMapData::InvalidateStaleResolves()
+{
+	TileSetRevisions.SetNum(TileSets.Num());
+
+	TBitArray<> StaleTileSetIds(false, TileSets.Num() + 1);
+	bool bAnyStale = false;
+	for (int32 TileSetIndex = 0; TileSetIndex < TileSets.Num(); ++TileSetIndex)
+	{
+		const UGridMapTileSet* TileSet = TileSets[TileSetIndex];
+		if (TileSet && TileSetRevisions[TileSetIndex] != TileSet->TilesRevision)
+		{
+			TileSetRevisions[TileSetIndex] = TileSet->TilesRevision;
+			StaleTileSetIds[TileSetIndex + 1] = true;
+			bAnyStale = true;
+		}
+	}
+
+	if (!bAnyStale)
+		return;
+
+	for (FGridMapDataChunk& Chunk : Chunks)
+	{
+		for (int32 ChunkIndex = 0; ChunkIndex < CellsPerChunk; ++ChunkIndex)
+		{
+			if (StaleTileSetIds[Chunk.TileSetIds[ChunkIndex]])
+			{
+				Chunk.TileLists[ChunkIndex] = Unresolved;
+			}
+		}
+	}
+	MarkPackageDirty();
+}
+
+void UGridMapData::GetCells(TArray<FIntVector>& OutCells) const
+{
+	OutCells.Reserve(OutCells.Num() + NumTiles);
+	for (const FGridMapDataChunk& Chunk : Chunks)
+	{
+		for (int32 ChunkIndex = 0; ChunkIndex < CellsPerChunk; ++ChunkIndex)
+		{
+			if (Chunk.TileSetIds[ChunkIndex] != 0)
+			{
+				OutCells.Add(ChunkIndexToCell(Chunk.ChunkCoord, ChunkIndex));
+			}
+		}
+	}
+}
+
+void UGridMapData::Empty()
+{
+	if (NumTiles == 0 && Chunks.Num() == 0)
+		return;
+
+	TileSets.Empty();
+	TileSetRevisions.Empty();
+	Chunks.Empty();
+	ChunkIndexByCoord.Empty();
+	NumTiles = 0;
+	MarkPackageDirty();
+}
+
+void UGridMapData::PostLoad()
+{
+	Super::PostLoad();
+	RebuildChunkLookup();
+
+	// older data has no revisions, tile sets edited since then are resolved again on the next rebuild
+	TileSetRevisions.SetNum(TileSets.Num());
+}
+
+#if WITH_EDITOR
+void UGridMapData::PostEditUndo()
+{
+	Super::PostEditUndo();
+	RebuildChunkLookup();
+}
+#endif
+
+void UGridMapData::RebuildChunkLookup()
+{
+	ChunkIndexByCoord.Reset();
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		ChunkIndexByCoord.Add(Chunks[ChunkIndex].ChunkCoord, ChunkIndex);
+	}
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridMapInfo.h"
+#include "GridMapData.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+#if WITH_EDITOR
+AGridMapInfo::FOnSeedChanged AGridMapInfo::OnSeedChanged;
+#endif
+
+AGridMapInfo::AGridMapInfo(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Seed(0)
+{
+	Data = CreateDefaultSubobject<UGridMapData>(TEXT("Data"));
+}
+
+AGridMapInfo* AGridMapInfo::GetForLevel(ULevel* Level, bool bCreateIfNone)
+{
+	if (Level == nullptr)
+		return nullptr;
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (AGridMapInfo* GridMapInfo = Cast<AGridMapInfo>(Actor))
+		{
+			if (IsValid(GridMapInfo))
+				return GridMapInfo;
+		}
+	}
+
+	if (!bCreateIfNone)
+		return nullptr;
+
+	UWorld* World = Level->GetWorld();
+	if (World == nullptr)
+		return nullptr;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.OverrideLevel = Level;
+	return World->SpawnActor<AGridMapInfo>(SpawnParameters);
+}
+
+#if WITH_EDITOR
+void AGridMapInfo::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(AGridMapInfo, Seed))
+	{
+		OnSeedChanged.Broadcast(this);
+	}
+}
+
+void AGridMapInfo::PreEditUndo()
+{
+	Super::PreEditUndo();
+	SeedBeforeUndo = Seed;
+}
+
+void AGridMapInfo::PostEditUndo()
+{
+	Super::PostEditUndo();
+
+	if (Seed != SeedBeforeUndo)
+	{
+		OnSeedChanged.Broadcast(this);
+	}
+}
+#endif
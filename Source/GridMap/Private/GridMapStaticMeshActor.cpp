@@ -2,9 +2,78 @@
 
 
 #include "GridMapStaticMeshActor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GridMapChunkActor.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGridMap, Log, All);
+
+const FName AGridMapStaticMeshActor::TileChannelName(TEXT("GridMap"));
+
+static void SetTileOverlaps(const TArray<FString>& Args, UWorld* World);
+
+static FAutoConsoleCommandWithWorldAndArgs GridMapTileOverlapsCommand(
+	TEXT("GridMap.TileOverlaps"),
+	TEXT("Turns overlap events on (1) or off (0) for every tile in the world, to compare stat physics / stat collision with and without them"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&SetTileOverlaps));
 
 AGridMapStaticMeshActor::AGridMapStaticMeshActor(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
-	GetStaticMeshComponent()->SetGenerateOverlapEvents(true);
-}
\ No newline at end of file
+	// nothing looks tiles up through overlaps, and thousands of them taking part
+	// in overlap updates whenever something moves adds up
+	GetStaticMeshComponent()->SetGenerateOverlapEvents(false);
+
+	// the channel comes from the project's settings, which the class default object can't rely on
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		GetStaticMeshComponent()->SetCollisionObjectType(GetTileObjectType());
+	}
+}
+
+ECollisionChannel AGridMapStaticMeshActor::GetTileObjectType()
+{
+	// only looked up once, a channel added in the project settings is picked up after a restart
+	static const ECollisionChannel TileObjectType = []()
+	{
+		FName ChannelName = TileChannelName;
+		const int32 Channel = UCollisionProfile::Get()->ReturnContainerIndexFromChannelName(ChannelName);
+		return Channel != INDEX_NONE ? (ECollisionChannel)Channel : ECC_WorldStatic;
+	}();
+
+	return TileObjectType;
+}
+
+static void SetTileOverlaps(const TArray<FString>& Args, UWorld* World)
+{
+	if (World == nullptr)
+		return;
+
+	const bool bGenerateOverlapEvents = Args.Num() > 0 && FCString::Atoi(*Args[0]) != 0;
+
+	int32 NumTiles = 0;
+	for (TActorIterator<AGridMapStaticMeshActor> It(World); It; ++It)
+	{
+		It->GetStaticMeshComponent()->SetGenerateOverlapEvents(bGenerateOverlapEvents);
+		++NumTiles;
+	}
+
+	// instanced tiles too, one component covers a whole mesh's worth of them
+	for (TActorIterator<AGridMapChunkActor> It(World); It; ++It)
+	{
+		for (const TPair<FIntVector, FGridMapChunkTile>& Tile : It->GetTiles())
+		{
+			if (Tile.Value.Component)
+			{
+				Tile.Value.Component->SetGenerateOverlapEvents(bGenerateOverlapEvents);
+			}
+			++NumTiles;
+		}
+	}
+
+	UE_LOG(LogGridMap, Display, TEXT("Overlap events %s for %d tiles"), bGenerateOverlapEvents ? TEXT("on") : TEXT("off"), NumTiles);
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GridMapTileSetCompatibility.h"
+#include "TileSet.h"
+
+FGridMapTileSetCompatibility& FGridMapTileSetCompatibility::Get()
+{
+	static FGridMapTileSetCompatibility Instance;
+	return Instance;
+}
+
+int32 FGridMapTileSetCompatibility::GetTileSetId(const UGridMapTileSet* TileSet)
+{
+	check(IsInGameThread());
+	check(TileSet);
+
+	if (const int32* ExistingId = TileSetIds.Find(TileSet))
+		return *ExistingId;
+
+	const int32 NewId = TileSets.Add(TileSet);
+	TileSetIds.Add(TileSet, NewId);
+
+	// the existing sets against the new one, then the new one against everything
+	for (int32 Id = 0; Id < NewId; ++Id)
+	{
+		Matrix[Id].Add(ComputeCompatible(TileSets[Id].Get(), TileSet));
+	}
+
+	TBitArray<>& Row = Matrix.AddDefaulted_GetRef();
+	Row.Reserve(TileSets.Num());
+	for (int32 Id = 0; Id <= NewId; ++Id)
+	{
+		Row.Add(ComputeCompatible(TileSet, TileSets[Id].Get()));
+	}
+
+	return NewId;
+}
+
+bool FGridMapTileSetCompatibility::IsCompatible(const UGridMapTileSet* TileSet, const UGridMapTileSet* Neighbour)
+{
+	const int32 TileSetId = GetTileSetId(TileSet);
+	return IsCompatible(TileSetId, GetTileSetId(Neighbour));
+}
+
+void FGridMapTileSetCompatibility::Invalidate(const UGridMapTileSet* TileSet)
+{
+	check(IsInGameThread());
+
+	const int32* ChangedId = TileSetIds.Find(TileSet);
+	if (ChangedId == nullptr)
+		return;
+
+	for (int32 Id = 0; Id < TileSets.Num(); ++Id)
+	{
+		Matrix[*ChangedId][Id] = ComputeCompatible(TileSet, TileSets[Id].Get());
+		Matrix[Id][*ChangedId] = ComputeCompatible(TileSets[Id].Get(), TileSet);
+	}
+}
+
+bool FGridMapTileSetCompatibility::ComputeCompatible(const UGridMapTileSet* TileSet, const UGridMapTileSet* Neighbour)
+{
+	return TileSet && Neighbour && TileSet->AdjacencyTagRequirements.RequirementsMet(Neighbour->TileTags);
+}
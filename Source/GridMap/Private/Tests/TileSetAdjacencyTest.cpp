@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "TileSet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridMapTileSetAdjacencyLookupTest, "GridMap.TileSet.AdjacencyLookup", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FGridMapTileSetAdjacencyLookupTest::RunTest(const FString& Parameters)
+{
+	static const TCHAR* TileSetPaths[] = {
+		TEXT("/GridMapEditor/TS_Floor_Test.TS_Floor_Test"),
+		TEXT("/GridMapEditor/TS_Wall_Test.TS_Wall_Test"),
+	};
+
+	for (const TCHAR* TileSetPath : TileSetPaths)
+	{
+		const UGridMapTileSet* TileSet = LoadObject<UGridMapTileSet>(nullptr, TileSetPath);
+		if (!TestNotNull(FString::Printf(TEXT("%s loads"), TileSetPath), TileSet))
+			continue;
+
+		// without the lookup both sides would be the same search
+		if (!TestTrue(FString::Printf(TEXT("%s has its adjacency lookup"), TileSetPath), TileSet->HasAdjacencyLookup()))
+			continue;
+
+		for (uint32 Bitmask = 0; Bitmask < UGridMapTileSet::AdjacencyLookupSize; ++Bitmask)
+		{
+			const int32 Expected = TileSet->FindTilesIndexForAdjacency(Bitmask);
+			const FGridMapTileList* ExpectedTiles = TileSet->Tiles.IsValidIndex(Expected) ? &TileSet->Tiles[Expected] : nullptr;
+
+			TestEqual(FString::Printf(TEXT("%s tile list for mask 0x%02X"), TileSetPath, Bitmask), TileSet->FindTileListIndexForAdjacency(Bitmask), Expected);
+			TestTrue(FString::Printf(TEXT("%s tiles for mask 0x%02X"), TileSetPath, Bitmask), TileSet->FindTilesForAdjacency(Bitmask) == ExpectedTiles);
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 
 #include "TileSet.h"
+#include "GridMapTileSetCompatibility.h"
 
 UGridMapTileSet::UGridMapTileSet()
 	: TileSize(100)
@@ -18,17 +19,106 @@ TSoftObjectPtr<class UStaticMesh> FGridMapTileList::GetRandomTile() const
 	return Tiles[RandomElementIndex];
 }
 
+TSoftObjectPtr<class UStaticMesh> FGridMapTileList::GetTileForCell(const FIntVector& Cell, int32 Seed) const
+{
+	const int32 Variant = GetVariantForCell(Cell, Seed);
+	return Tiles.IsValidIndex(Variant) ? Tiles[Variant] : TSoftObjectPtr<class UStaticMesh>();
+}
+
+int32 FGridMapTileList::GetVariantForCell(const FIntVector& Cell, int32 Seed) const
+{
+	if (Tiles.Num() == 0)
+		return INDEX_NONE;
+
+	if (Tiles.Num() == 1)
+		return 0;
+
+	uint32 Hash = HashCombine(GetTypeHash(Cell), GetTypeHash(Seed));
+	Hash = HashCombine(Hash, GetTypeHash(TileAdjacency.Bitset));
+	return Hash % (uint32)Tiles.Num();
+}
+
 const FGridMapTileList* UGridMapTileSet::FindTilesForAdjacency(uint32 bitmask) const
 {
-	const FGridMapTileList* GridMapTileList = SearchForTilesWithCompatibleAdjacency(bitmask);
+	const int32 TileListIndex = FindTileListIndexForAdjacency(bitmask);
+	return Tiles.IsValidIndex(TileListIndex) ? &Tiles[TileListIndex] : nullptr;
+}
+
+int32 UGridMapTileSet::FindTileListIndexForAdjacency(uint32 bitmask) const
+{
+	int32 TileListIndex = INDEX_NONE;
+	if (AdjacencyLookup.Num() == AdjacencyLookupSize)
+	{
+		TileListIndex = AdjacencyLookup[bitmask & (AdjacencyLookupSize - 1)];
+	}
+	else
+	{
+		// lookup hasn't been built yet (ie. a brand new tile set), fall back on searching
+		TileListIndex = FindTilesIndexForAdjacency(bitmask);
+	}
+
+	return TileListIndex;
+}
+
+int32 UGridMapTileSet::FindTilesIndexForAdjacency(uint32 bitmask) const
+{
+	int32 TileListIndex = SearchForTilesWithCompatibleAdjacency(bitmask);
 	// If we couldn't find a matching tile, we might be relying on 4 way
 	// tiles, so let's mask off the upper bits and check again
-	if (!GridMapTileList)
-		GridMapTileList = SearchForTilesWithCompatibleAdjacency(bitmask & 0xF);
-	return GridMapTileList;
+	if (TileListIndex == INDEX_NONE)
+		TileListIndex = SearchForTilesWithCompatibleAdjacency(bitmask & 0xF);
+	return TileListIndex;
+}
+
+void UGridMapTileSet::BuildAdjacencyLookup()
+{
+	AdjacencyLookup.SetNumUninitialized(AdjacencyLookupSize);
+	for (int32 bitmask = 0; bitmask < AdjacencyLookupSize; ++bitmask)
+	{
+		AdjacencyLookup[bitmask] = FindTilesIndexForAdjacency(bitmask);
+	}
+}
+
+void UGridMapTileSet::PostLoad()
+{
+	Super::PostLoad();
+
+	// cooked data already has the lookup serialized, only the editor needs to
+	// worry about it being out of date
+#if WITH_EDITOR
+	BuildAdjacencyLookup();
+#else
+	if (AdjacencyLookup.Num() != AdjacencyLookupSize)
+	{
+		BuildAdjacencyLookup();
+	}
+#endif
+}
+
+#if WITH_EDITOR
+void UGridMapTileSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	BuildAdjacencyLookup();
+	TilesRevision = FGuid::NewGuid();
+
+	const FName PropertyName = PropertyChangedEvent.GetMemberPropertyName();
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(UGridMapTileSet, TileTags) || PropertyName == GET_MEMBER_NAME_CHECKED(UGridMapTileSet, AdjacencyTagRequirements))
+	{
+		FGridMapTileSetCompatibility::Get().Invalidate(this);
+	}
+}
+
+void UGridMapTileSet::PostEditUndo()
+{
+	Super::PostEditUndo();
+	BuildAdjacencyLookup();
+	TilesRevision = FGuid::NewGuid();
+	FGridMapTileSetCompatibility::Get().Invalidate(this);
 }
+#endif
 
-const FGridMapTileList* UGridMapTileSet::SearchForTilesWithCompatibleAdjacency(uint32 bitmask) const
+int32 UGridMapTileSet::SearchForTilesWithCompatibleAdjacency(uint32 bitmask) const
 {
 	static const TTuple<uint32, uint32> TopLeft((1 << 0) | (1 << 1), ~(1 << 4));
 	static const TTuple<uint32, uint32> TopRight((1 << 0) | (1 << 2), ~(1 << 5));
@@ -51,8 +141,8 @@ const FGridMapTileList* UGridMapTileSet::SearchForTilesWithCompatibleAdjacency(u
 			filteredBitmask &= BottomRight.Value;
 
 		if (tileBitmask == filteredBitmask)
-			return &Tiles[i];
+			return i;
 	}
 
-	return nullptr;
+	return INDEX_NONE;
 }
\ No newline at end of file
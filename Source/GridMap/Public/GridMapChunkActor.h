@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GridMapChunkActor.generated.h"
+
+class UGridMapTileSet;
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+USTRUCT()
+struct GRIDMAP_API FGridMapChunkTile
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TObjectPtr<UGridMapTileSet> TileSet;
+
+	UPROPERTY()
+	TObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component;
+
+	UPROPERTY()
+	int32 InstanceIndex = INDEX_NONE;
+};
+
+USTRUCT()
+struct GRIDMAP_API FGridMapChunkMeshInstances
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	TObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component;
+
+	/** The cell each instance of the component belongs to */
+	UPROPERTY()
+	TArray<FIntVector> InstanceCells;
+};
+
+/**
+ * Renders a square chunk of grid map tiles as instances, with one
+ * hierarchical instanced component per distinct mesh. Chunks cover the
+ * same cells as the grid data's, see UGridMapData::CellToChunk.
+ */
+UCLASS(NotPlaceable)
+class GRIDMAP_API AGridMapChunkActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGridMapChunkActor(const FObjectInitializer& ObjectInitializer = FObjectInitializer());
+
+	// AActor interface
+	virtual void PostLoad() override;
+	// End of AActor interface
+
+	/** Sets up an empty chunk */
+	void InitChunk(const FIntVector& InChunkCoord, int32 InCellSize, int32 InCellHeight);
+
+	/** Adds a tile instance at the cell, replacing whatever was there. Recorded for undo along with the component it goes in */
+	void SetTile(const FIntVector& Cell, UGridMapTileSet* TileSet, UStaticMesh* StaticMesh, const FRotator& Rotation);
+
+	/** Removes the tile instance at the cell, returns false if there wasn't one. Recorded for undo like SetTile */
+	bool RemoveTile(const FIntVector& Cell);
+
+	const FGridMapChunkTile* FindTile(const FIntVector& Cell) const;
+	UStaticMesh* GetTileMesh(const FIntVector& Cell) const;
+	FRotator GetTileRotation(const FIntVector& Cell) const;
+
+	const TMap<FIntVector, FGridMapChunkTile>& GetTiles() const { return Tiles; }
+	bool IsEmpty() const { return Tiles.Num() == 0; }
+
+	FIntVector GetChunkCoord() const { return ChunkCoord; }
+	int32 GetCellSize() const { return CellSize; }
+	int32 GetCellHeight() const { return CellHeight > 0 ? CellHeight : CellSize; }
+
+private:
+	FTransform GetCellTransform(const FIntVector& Cell, const FRotator& Rotation) const;
+	FGridMapChunkMeshInstances* FindMeshInstances(const UHierarchicalInstancedStaticMeshComponent* Component);
+	FGridMapChunkMeshInstances& FindOrAddMeshInstances(UStaticMesh* StaticMesh);
+	/** Collision settings every tile component gets, no overlap events and the tiles' object channel */
+	static void SetTileCollision(UHierarchicalInstancedStaticMeshComponent* Component);
+
+	UPROPERTY()
+	FIntVector ChunkCoord;
+
+	UPROPERTY()
+	int32 CellSize;
+
+	/** 0 for chunks saved before cells had their own height, those were stacked by CellSize */
+	UPROPERTY()
+	int32 CellHeight;
+
+	UPROPERTY()
+	TMap<FIntVector, FGridMapChunkTile> Tiles;
+
+	UPROPERTY()
+	TArray<FGridMapChunkMeshInstances> MeshInstances;
+};
@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "GridMapData.generated.h"
+
+class UGridMapTileSet;
+
+/**
+ * A square block of cells, stored as one flat array per field.
+ * Cells are laid out row by row, ie. X + Y * ChunkSize.
+ */
+USTRUCT()
+struct GRIDMAP_API FGridMapDataChunk
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY()
+	FIntVector ChunkCoord = FIntVector::ZeroValue;
+
+	/** Index into the data's tile sets plus one, 0 for an empty cell */
+	UPROPERTY()
+	TArray<uint16> TileSetIds;
+
+	/** Which of the tile set's lists the cell resolved to, and so its rotation */
+	UPROPERTY()
+	TArray<uint8> TileLists;
+
+	/** Which mesh in that list */
+	UPROPERTY()
+	TArray<uint8> Variants;
+
+	/** Neighbour mask the cell was last resolved with */
+	UPROPERTY()
+	TArray<uint8> Masks;
+
+	UPROPERTY()
+	int32 NumTiles = 0;
+};
+
+/** Everything stored for a single cell */
+struct FGridMapCell
+{
+	UGridMapTileSet* TileSet = nullptr;
+	int32 TileList = INDEX_NONE;
+	int32 Variant = INDEX_NONE;
+	uint8 Mask = 0;
+
+	bool IsResolved() const { return TileList != INDEX_NONE; }
+};
+
+/**
+ * Which tile set is in each cell and what it resolved to, kept in fixed size
+ * chunks so queries and rebuilds run over flat arrays instead of actors.
+ * This is the level's grid, the tile actors and instances are a view of it:
+ * edits change the data first and the editor brings the view in line after.
+ */
+UCLASS()
+class GRIDMAP_API UGridMapData : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** Number of cells along each side of a chunk, matches the instanced chunk actors */
+	static constexpr int32 ChunkSize = 32;
+	static constexpr int32 CellsPerChunk = ChunkSize * ChunkSize;
+
+	/** Stored in TileLists for cells that haven't been resolved since their tile set changed */
+	static constexpr uint8 Unresolved = 0xFF;
+
+	static FIntVector CellToChunk(const FIntVector& Cell);
+	static int32 CellToChunkIndex(const FIntVector& Cell);
+	static FIntVector ChunkIndexToCell(const FIntVector& ChunkCoord, int32 ChunkIndex);
+
+	UGridMapTileSet* GetTileSet(const FIntVector& Cell) const;
+	bool GetCell(const FIntVector& Cell, FGridMapCell& OutCell) const;
+
+	/**
+	 * Puts the tile set in the cell (null empties it), the cell is unresolved until SetResolved.
+	 * Nothing is recorded for undo, callers either record the cells they change or Modify first.
+	 */
+	void SetTileSet(const FIntVector& Cell, UGridMapTileSet* TileSet);
+
+	/** Records what the cell's tile resolved to, same as SetTileSet as far as undo goes */
+	void SetResolved(const FIntVector& Cell, int32 TileList, int32 Variant, uint8 Mask);
+
+	/**
+	 * Marks the cells of every tile set that was edited since they were resolved as unresolved,
+	 * so they're resolved again instead of keeping a tile list that may not exist any more.
+	 */
+	void InvalidateStaleResolves();
+
+	/** Tile set ids run from 1 to this, inclusive */
+	int32 GetNumTileSets() const { return TileSets.Num(); }
+	UGridMapTileSet* GetTileSetById(uint16 TileSetId) const { return TileSetId > 0 && TileSets.IsValidIndex(TileSetId - 1) ? TileSets[TileSetId - 1] : nullptr; }
+
+	const FGridMapDataChunk* FindChunk(const FIntVector& ChunkCoord) const;
+	const TArray<FGridMapDataChunk>& GetChunks() const { return Chunks; }
+
+	/** Every occupied cell */
+	void GetCells(TArray<FIntVector>& OutCells) const;
+
+	int32 Num() const { return NumTiles; }
+	void Empty();
+
+	// UObject interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditUndo() override;
+#endif
+	// End of UObject interface
+
+private:
+	uint16 FindOrAddTileSetId(UGridMapTileSet* TileSet);
+	FGridMapDataChunk* FindChunk(const FIntVector& ChunkCoord);
+	FGridMapDataChunk& FindOrAddChunk(const FIntVector& ChunkCoord);
+	void RemoveChunk(const FIntVector& ChunkCoord);
+	void RebuildChunkLookup();
+
+	/** Every tile set used by the map, cells refer to them by index */
+	UPROPERTY()
+	TArray<TObjectPtr<UGridMapTileSet>> TileSets;
+
+	/** Each tile set's TilesRevision as of when its cells were last known to be resolved against it */
+	UPROPERTY()
+	TArray<FGuid> TileSetRevisions;
+
+	UPROPERTY()
+	TArray<FGridMapDataChunk> Chunks;
+
+	UPROPERTY()
+	int32 NumTiles = 0;
+
+	TMap<FIntVector, int32> ChunkIndexByCoord;
+};
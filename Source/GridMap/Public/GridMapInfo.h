@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "GridMapInfo.generated.h"
+
+/**
+ * Per level grid map settings
+ */
+UCLASS(NotPlaceable)
+class GRIDMAP_API AGridMapInfo : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AGridMapInfo(const FObjectInitializer& ObjectInitializer = FObjectInitializer());
+
+	/** Returns the grid map info for the level, optionally creating one if it doesn't exist */
+	static AGridMapInfo* GetForLevel(class ULevel* Level, bool bCreateIfNone);
+
+	/** Seed used to pick between tile variants, changing it rerolls every tile */
+	UPROPERTY(EditAnywhere, Category = "Grid Map")
+	int32 Seed;
+
+	/** The level's grid, the tile actors and instances are built from it by the editor */
+	UPROPERTY()
+	TObjectPtr<class UGridMapData> Data;
+
+#if WITH_EDITOR
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnSeedChanged, AGridMapInfo*);
+	/** Broadcast when the seed is edited or an edit to it is undone, so the tiles can be rerolled */
+	static FOnSeedChanged OnSeedChanged;
+
+	// UObject interface
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PreEditUndo() override;
+	virtual void PostEditUndo() override;
+	// End of UObject interface
+
+private:
+	int32 SeedBeforeUndo = 0;
+#endif
+};
@@ -17,6 +17,12 @@ class GRIDMAP_API AGridMapStaticMeshActor : public AStaticMeshActor
 public:
 	AGridMapStaticMeshActor(const FObjectInitializer& ObjectInitializer = FObjectInitializer());
 
+	/** Name of the object channel tiles go in, add it to the project's collision settings to give them their own */
+	static const FName TileChannelName;
+
+	/** The tiles' object channel, ECC_WorldStatic if the project doesn't have one named TileChannelName */
+	static ECollisionChannel GetTileObjectType();
+
 	UPROPERTY()
 	TObjectPtr<class UGridMapTileSet> TileSet;	
 };
@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("GridMap"), STATGROUP_GridMap, STATCAT_Advanced);
+
+/** Per frame counters, see them with "stat GridMap" */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cell Queries"), STAT_GridMap_CellQueries, STATGROUP_GridMap, GRIDMAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tiles Resolved"), STAT_GridMap_TilesResolved, STATGROUP_GridMap, GRIDMAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tiles Changed"), STAT_GridMap_TilesChanged, STATGROUP_GridMap, GRIDMAP_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tiles Unchanged Mask"), STAT_GridMap_TilesUnchangedMask, STATGROUP_GridMap, GRIDMAP_API);
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class UGridMapTileSet;
+
+/**
+ * Gives every tile set a small id and caches whether each set's adjacency
+ * requirements are met by each other set's tags, so working out adjacency is
+ * a bit test rather than a tag container query per neighbour.
+ */
+class GRIDMAP_API FGridMapTileSetCompatibility
+{
+public:
+	static FGridMapTileSetCompatibility& Get();
+
+	/** Id of the tile set, registering it if it hasn't been seen yet. Game thread only. */
+	int32 GetTileSetId(const UGridMapTileSet* TileSet);
+
+	/** True if TileSetId's adjacency requirements are met by NeighbourId's tags, safe to call from any thread while nothing is being registered */
+	bool IsCompatible(int32 TileSetId, int32 NeighbourId) const
+	{
+		return Matrix[TileSetId][NeighbourId];
+	}
+
+	/** Same as above, registering either set if needed. Game thread only. */
+	bool IsCompatible(const UGridMapTileSet* TileSet, const UGridMapTileSet* Neighbour);
+
+	/** Recomputes the tile set's row and column, after its tags or requirements changed */
+	void Invalidate(const UGridMapTileSet* TileSet);
+
+private:
+	/** Whether the set's requirements are met by the other set, false if either one is gone */
+	static bool ComputeCompatible(const UGridMapTileSet* TileSet, const UGridMapTileSet* Neighbour);
+
+	TMap<TObjectKey<UGridMapTileSet>, int32> TileSetIds;
+	TArray<TWeakObjectPtr<const UGridMapTileSet>> TileSets;
+
+	/** Matrix[A][B] is true if A's adjacency requirements are met by B's tags */
+	TArray<TBitArray<>> Matrix;
+};
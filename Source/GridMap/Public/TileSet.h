@@ -34,6 +34,12 @@ public:
 	TArray<TSoftObjectPtr<class UStaticMesh>> Tiles;
 
 	TSoftObjectPtr<class UStaticMesh> GetRandomTile() const;
+
+	/** Picks a tile variant from a stable hash of the cell and seed, so the same cell always resolves to the same mesh */
+	TSoftObjectPtr<class UStaticMesh> GetTileForCell(const FIntVector& Cell, int32 Seed) const;
+
+	/** Index of the variant GetTileForCell picks, INDEX_NONE if the list is empty */
+	int32 GetVariantForCell(const FIntVector& Cell, int32 Seed) const;
 };
 
 /**
@@ -66,9 +72,40 @@ public:
 	TArray<FGridMapTileList> Tiles;
 
 	const FGridMapTileList* FindTilesForAdjacency(uint32 bitmask) const;
+	/** Same as above, but the index into Tiles (INDEX_NONE if nothing matches) */
+	int32 FindTileListIndexForAdjacency(uint32 bitmask) const;
+
+	/**
+	 * Searches Tiles for the bitmask directly, falling back on just the edge bits,
+	 * which is what the lookup is built from. Slow, use FindTileListIndexForAdjacency.
+	 */
+	int32 FindTilesIndexForAdjacency(uint32 bitmask) const;
+
+	/** Rebuilds AdjacencyLookup from Tiles, needs to be called whenever Tiles changes */
+	void BuildAdjacencyLookup();
+	bool HasAdjacencyLookup() const { return AdjacencyLookup.Num() == AdjacencyLookupSize; }
+
+	/** Renewed whenever the tile set is edited, grid data throws away what its cells resolved to against an older one */
+	UPROPERTY()
+	FGuid TilesRevision;
+
+	// UObject interface
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	virtual void PostEditUndo() override;
+#endif
+	// End of UObject interface
+
+	/** One entry per possible 8 neighbour bitmask */
+	static constexpr int32 AdjacencyLookupSize = 256;
 
 protected:
-	const FGridMapTileList* SearchForTilesWithCompatibleAdjacency(uint32 bitmask) const;
+	int32 SearchForTilesWithCompatibleAdjacency(uint32 bitmask) const;
+
+	/** Index into Tiles for each possible neighbour bitmask, INDEX_NONE if nothing matches */
+	UPROPERTY()
+	TArray<int32> AdjacencyLookup;
 
 public:
 	//this can't be here, it breaks non-editor builds :/
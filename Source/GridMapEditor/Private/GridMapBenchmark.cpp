@@ -0,0 +1,186 @@
+#include "GridMapBenchmark.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GridMapEditor.h"
+#include "GridMapEditorMode.h"
+#include "GridMapStaticMeshActor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "TileSet.h"
+
+static FAutoConsoleCommandWithArgs GridMapBenchmarkRebuildCommand(
+	TEXT("GridMap.Benchmark.Rebuild"),
+	TEXT("Times a full tile rebuild on synthetic square grids of each of the given tile counts (default 1000 10000 50000 100000 200000), in a scratch world"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&FGridMapBenchmark::RunRebuildBenchmark));
+
+const TCHAR* const FGridMapBenchmark::TestTileSets[2] = {
+	TEXT("/GridMapEditor/TS_Floor_Test.TS_Floor_Test"),
+	TEXT("/GridMapEditor/TS_Wall_Test.TS_Wall_Test"),
+};
+
+FGridMapBenchmark::FGridMapBenchmark()
+{
+	World = UWorld::CreateWorld(EWorldType::Editor, false, TEXT("GridMapBenchmark"));
+	GEngine->CreateNewWorldContext(EWorldType::Editor).SetCurrentWorld(World);
+
+	// never entered, so it doesn't listen to the level editor or show up in it
+	EditorMode = MakeShared<FGridMapEditorMode>();
+	EditorMode->WorldOverride = World;
+	EditorMode->bTransactEdits = false;
+}
+
+FGridMapBenchmark::~FGridMapBenchmark()
+{
+	// the streamer's callbacks point back at the mode
+	EditorMode->MeshStreamer.FlushRequestsSynchronous();
+	EditorMode.Reset();
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void FGridMapBenchmark::RunRebuildBenchmark(const TArray<FString>& Args)
+{
+	UGridMapTileSet* TileSet = LoadObject<UGridMapTileSet>(nullptr, TestTileSets[0]);
+	if (TileSet == nullptr)
+	{
+		UE_LOG(LogGridMapEditor, Error, TEXT("GridMap.Benchmark.Rebuild couldn't load %s"), TestTileSets[0]);
+		return;
+	}
+
+	const TArray<int32> TileCounts = ParseTileCounts(Args, { 1000, 10000, 50000, 100000, 200000 });
+
+	UE_LOG(LogGridMapEditor, Display, TEXT("Rebuild benchmark using %s"), *TileSet->GetName());
+
+	for (int32 TileCount : TileCounts)
+	{
+		// a fresh world each time, nothing left over from the last grid
+		FGridMapBenchmark Benchmark;
+		const int32 SpawnedTiles = Benchmark.SpawnSyntheticGrid(TileSet, TileCount);
+
+		const double StartTime = FPlatformTime::Seconds();
+		Benchmark.UpdateAllTiles();
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		UE_LOG(LogGridMapEditor, Display, TEXT("  %8d tiles: %10.2f ms (%.3f us/tile)"), SpawnedTiles, ElapsedMs, SpawnedTiles > 0 ? ElapsedMs * 1000.0 / SpawnedTiles : 0.0);
+	}
+}
+
+void FGridMapBenchmark::SetTileSet(UGridMapTileSet* TileSet)
+{
+	EditorMode->SetActiveTileSet(TileSet);
+}
+
+int32 FGridMapBenchmark::SpawnSyntheticGrid(UGridMapTileSet* TileSet, int32 TileCount)
+{
+	SetTileSet(TileSet);
+
+	const FGridMapCellIndex& Index = EditorMode->GetCellIndex(World);
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt((float)TileCount));
+
+	for (int32 Y = 0; Y < Side; ++Y)
+	{
+		for (int32 X = 0; X < Side; ++X)
+		{
+			const FVector Location = Index.CellToLocation(FIntVector(X, Y, 0));
+			AGridMapStaticMeshActor* Tile = World->SpawnActor<AGridMapStaticMeshActor>(Location, FRotator::ZeroRotator);
+			Tile->TileSet = TileSet;
+			EditorMode->CellIndex.Add(Tile);
+		}
+	}
+
+	// the tiles go into the grid data the way an existing level's would on its first edit
+	EditorMode->CellIndex.FindOrCreateInfo();
+
+	return Index.Num();
+}
+
+void FGridMapBenchmark::UpdateAllTiles()
+{
+	EditorMode->UpdateAllTiles();
+}
+
+void FGridMapBenchmark::PressBrush(const FIntVector& Cell, bool bErase)
+{
+	const FGridMapCellIndex& Index = EditorMode->GetCellIndex(World);
+
+	EditorMode->UISettings.SetBatchStrokes(false);
+	EditorMode->UISettings.SetPaintMode(bErase ? EGridMapPaintMode::Erase : EGridMapPaintMode::Paint);
+	EditorMode->BrushLocation = Index.CellToLocation(Cell);
+	EditorMode->BrushTraceHitActor = Index.Find(Cell);
+	EditorMode->bBrushTraceValid = true;
+	EditorMode->bIsPainting = true;
+
+	EditorMode->UpdateStroke();
+	EditorMode->CommitStroke();
+
+	EditorMode->bIsPainting = false;
+	EditorMode->bBrushTraceValid = false;
+}
+
+void FGridMapBenchmark::DragBrush(const TArray<FIntVector>& Cells)
+{
+	const FGridMapCellIndex& Index = EditorMode->GetCellIndex(World);
+
+	EditorMode->UISettings.SetBatchStrokes(true);
+	EditorMode->UISettings.SetPaintMode(EGridMapPaintMode::Paint);
+	EditorMode->bBrushTraceValid = true;
+	EditorMode->bIsPainting = true;
+
+	for (const FIntVector& Cell : Cells)
+	{
+		EditorMode->BrushLocation = Index.CellToLocation(Cell);
+		EditorMode->UpdateStroke();
+	}
+	EditorMode->CommitStroke();
+
+	EditorMode->bIsPainting = false;
+	EditorMode->bBrushTraceValid = false;
+}
+
+TArray<int32> FGridMapBenchmark::ParseTileCounts(const TArray<FString>& Args, const TArray<int32>& DefaultTileCounts)
+{
+	TArray<int32> TileCounts;
+	for (const FString& Arg : Args)
+	{
+		if (Arg.IsNumeric())
+		{
+			TileCounts.Add(FCString::Atoi(*Arg));
+		}
+	}
+
+	return TileCounts.Num() > 0 ? TileCounts : DefaultTileCounts;
+}
+
+void FGridMapBenchmark::WritePerfResults(const FString& Rows)
+{
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("GridMap") / TEXT("Perf.csv");
+
+	// automation workers run in parallel, only one of them gets to check for and append to the file at a time
+	FSystemWideCriticalSection Lock(TEXT("GridMapPerfResults"));
+	if (!Lock.IsValid())
+	{
+		UE_LOG(LogGridMapEditor, Error, TEXT("Couldn't lock %s"), *Filename);
+		return;
+	}
+
+	FString Contents;
+	if (!IFileManager::Get().FileExists(*Filename))
+	{
+		Contents = TEXT("Timestamp,BuildVersion,TileSet,Operation,Tiles,Milliseconds\n");
+	}
+	Contents += Rows;
+
+	if (FFileHelper::SaveStringToFile(Contents, *Filename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogGridMapEditor, Display, TEXT("Wrote results to %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogGridMapEditor, Error, TEXT("Couldn't write results to %s"), *Filename);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FGridMapEditorMode;
+class UGridMapTileSet;
+class UWorld;
+
+/**
+ * A scratch editor world with a grid map mode of its own, for timing grid map operations
+ * on synthetic grids without touching the level being edited or the undo buffer
+ */
+class FGridMapBenchmark
+{
+public:
+	FGridMapBenchmark();
+	~FGridMapBenchmark();
+
+	/** GridMap.Benchmark.Rebuild [TileCount...] */
+	static void RunRebuildBenchmark(const TArray<FString>& Args);
+
+	UWorld* GetWorld() const { return World; }
+
+	/** Selects the tile set, which also sets the size of the cells */
+	void SetTileSet(UGridMapTileSet* TileSet);
+
+	/** Spawns a square grid of at least TileCount empty tiles, to be resolved by a rebuild, returns how many there are */
+	int32 SpawnSyntheticGrid(UGridMapTileSet* TileSet, int32 TileCount);
+
+	void UpdateAllTiles();
+
+	/** Puts the brush over the cell and presses it, the same as clicking there */
+	void PressBrush(const FIntVector& Cell, bool bErase);
+
+	/** Drags the brush over the cells in order and lets go, with stroke batching on */
+	void DragBrush(const TArray<FIntVector>& Cells);
+
+	static const TCHAR* const TestTileSets[2];
+
+	/** Appends the rows to Saved/GridMap/Perf.csv, so the file can be used to track trends over runs */
+	static void WritePerfResults(const FString& Rows);
+
+private:
+	static TArray<int32> ParseTileCounts(const TArray<FString>& Args, const TArray<int32>& DefaultTileCounts);
+
+	UWorld* World;
+	TSharedPtr<FGridMapEditorMode> EditorMode;
+};
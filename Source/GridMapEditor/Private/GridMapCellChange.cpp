@@ -0,0 +1,88 @@
+#include "GridMapCellChange.h"
+#include "GridMapData.h"
+#include "GridMapStats.h"
+#include "Misc/ITransaction.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "TileSet.h"
+
+DECLARE_CYCLE_STAT(TEXT("Load Synchronous (Undo)"), STAT_GridMap_UndoLoadSynchronous, STATGROUP_GridMap);
+
+FGridMapCellChange::FOnCellsRestored FGridMapCellChange::OnCellsRestored;
+
+FGridMapCellChange::FGridMapCellChange(TArray<FGridMapCellDelta>&& InDeltas)
+	: Deltas(MoveTemp(InDeltas))
+{
+}
+
+void FGridMapCellChange::Apply(UObject* Object)
+{
+	ApplyStates(Object, true);
+}
+
+void FGridMapCellChange::Revert(UObject* Object)
+{
+	ApplyStates(Object, false);
+}
+
+FString FGridMapCellChange::ToString() const
+{
+	return FString::Printf(TEXT("Grid map edit (%d cells)"), Deltas.Num());
+}
+
+FGridMapCellState FGridMapCellChange::GetCellState(const UGridMapData* Data, const FIntVector& Cell)
+{
+	FGridMapCellState State;
+	FGridMapCell DataCell;
+	if (Data && Data->GetCell(Cell, DataCell))
+	{
+		State.TileSet = DataCell.TileSet;
+		State.TileList = DataCell.TileList;
+		State.Variant = DataCell.Variant;
+		State.Mask = DataCell.Mask;
+	}
+	return State;
+}
+
+void FGridMapCellChange::SetTileSet(UGridMapData* Data, const FIntVector& Cell, UGridMapTileSet* TileSet)
+{
+	if (Data == nullptr)
+		return;
+
+	FGridMapCellState Before = GetCellState(Data, Cell);
+	Data->SetTileSet(Cell, TileSet);
+	FGridMapCellState After = GetCellState(Data, Cell);
+
+	if (GUndo && After != Before)
+	{
+		TArray<FGridMapCellDelta> Deltas;
+		Deltas.Add({ Cell, MoveTemp(Before), MoveTemp(After) });
+		GUndo->StoreUndo(Data, MakeUnique<FGridMapCellChange>(MoveTemp(Deltas)));
+	}
+}
+
+void FGridMapCellChange::ApplyStates(UObject* Object, bool bAfter) const
+{
+	UGridMapData* Data = Cast<UGridMapData>(Object);
+	if (Data == nullptr)
+		return;
+
+	// the recorded states already include the neighbours' re-resolves, so they go back as they were
+	TArray<FIntVector> Cells;
+	Cells.Reserve(Deltas.Num());
+	for (const FGridMapCellDelta& Delta : Deltas)
+	{
+		const FGridMapCellState& State = bAfter ? Delta.After : Delta.Before;
+		UGridMapTileSet* TileSet = nullptr;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GridMap_UndoLoadSynchronous);
+			TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_LoadSynchronous);
+			TileSet = State.TileSet.LoadSynchronous();
+		}
+
+		Data->SetTileSet(Delta.Cell, TileSet);
+		Data->SetResolved(Delta.Cell, State.TileList, State.Variant, State.Mask);
+		Cells.Add(Delta.Cell);
+	}
+
+	OnCellsRestored.Broadcast(Data, Cells);
+}
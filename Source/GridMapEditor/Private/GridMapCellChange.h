@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Change.h"
+#include "UObject/SoftObjectPtr.h"
+
+class UGridMapData;
+class UGridMapTileSet;
+
+/** What the grid data holds for a single cell, an empty tile set means there's no tile there */
+struct FGridMapCellState
+{
+	TSoftObjectPtr<UGridMapTileSet> TileSet;
+	int32 TileList = INDEX_NONE;
+	int32 Variant = INDEX_NONE;
+	uint8 Mask = 0;
+
+	bool operator==(const FGridMapCellState& Other) const
+	{
+		return TileSet == Other.TileSet && TileList == Other.TileList && Variant == Other.Variant && Mask == Other.Mask;
+	}
+
+	bool operator!=(const FGridMapCellState& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+struct FGridMapCellDelta
+{
+	FIntVector Cell;
+	FGridMapCellState Before;
+	FGridMapCellState After;
+};
+
+/**
+ * Undo record for an edit. Only holds the cells that actually changed, including the
+ * neighbours that were re-resolved, rather than a snapshot of the whole grid. Stored
+ * against the level's UGridMapData, the tile actors aren't recorded at all: once the
+ * data is back, the editor brings the restored cells' tiles in line with it.
+ */
+class FGridMapCellChange : public FCommandChange
+{
+public:
+	FGridMapCellChange(TArray<FGridMapCellDelta>&& InDeltas);
+
+	DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCellsRestored, UGridMapData*, const TArray<FIntVector>&);
+	/** Broadcast when undo or redo put cells back, their tiles still have to be synced and resolved */
+	static FOnCellsRestored OnCellsRestored;
+
+	// FCommandChange interface
+	virtual void Apply(UObject* Object) override;
+	virtual void Revert(UObject* Object) override;
+	virtual FString ToString() const override;
+	// End of FCommandChange interface
+
+	int32 Num() const { return Deltas.Num(); }
+
+	/** What the data holds for the cell, the default state if it's empty */
+	static FGridMapCellState GetCellState(const UGridMapData* Data, const FIntVector& Cell);
+
+	/**
+	 * Puts the tile set in the cell outside of a grid map edit, ie. when a tile actor was
+	 * added, moved or deleted by hand, recording it into whatever transaction is open.
+	 */
+	static void SetTileSet(UGridMapData* Data, const FIntVector& Cell, UGridMapTileSet* TileSet);
+
+private:
+	void ApplyStates(UObject* Object, bool bAfter) const;
+
+	TArray<FGridMapCellDelta> Deltas;
+};
@@ -0,0 +1,387 @@
+#include "GridMapCellIndex.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GridMapChunkActor.h"
+#include "GridMapData.h"
+#include "GridMapInfo.h"
+#include "GridMapStaticMeshActor.h"
+#include "GridMapStats.h"
+#include "GridMapTilePool.h"
+#include "TileSet.h"
+
+FGridMapCellIndex::FGridMapCellIndex()
+	: CellSize(0)
+	, CellHeight(0)
+	, bIsValid(false)
+	, Revision(0)
+{
+}
+
+void FGridMapCellIndex::Rebuild(UWorld* InWorld, int32 InCellSize, int32 InCellHeight, const FGridMapTilePool* Pool)
+{
+	World = InWorld;
+	CellSize = InCellSize;
+	CellHeight = InCellHeight;
+	Cells.Reset();
+	TileCells.Reset();
+	Chunks.Reset();
+	Info.Reset();
+	Data.Reset();
+	bIsValid = true;
+	++Revision;
+
+	if (InWorld == nullptr)
+		return;
+
+	// looking at a level never adds grid data to it, that waits for the first edit
+	if (AGridMapInfo* GridMapInfo = AGridMapInfo::GetForLevel(InWorld->PersistentLevel, false))
+	{
+		Info = GridMapInfo;
+		Data = GridMapInfo->Data.Get();
+	}
+
+	for (TActorIterator<AGridMapStaticMeshActor> It(InWorld); It; ++It)
+	{
+		if (IsValid(*It) && !(Pool && Pool->IsPooled(*It)))
+		{
+			Add(*It);
+		}
+	}
+
+	for (TActorIterator<AGridMapChunkActor> It(InWorld); It; ++It)
+	{
+		if (IsValid(*It))
+		{
+			AddChunk(*It);
+		}
+	}
+}
+
+AGridMapInfo* FGridMapCellIndex::FindOrCreateInfo()
+{
+	if (AGridMapInfo* GridMapInfo = Info.Get())
+		return GridMapInfo;
+
+	UWorld* IndexWorld = World.Get();
+	if (IndexWorld == nullptr)
+		return nullptr;
+
+	AGridMapInfo* GridMapInfo = AGridMapInfo::GetForLevel(IndexWorld->PersistentLevel, false);
+	const bool bCreated = GridMapInfo == nullptr;
+	if (bCreated)
+	{
+		// part of whatever edit asked for it
+		IndexWorld->PersistentLevel->Modify();
+		GridMapInfo = AGridMapInfo::GetForLevel(IndexWorld->PersistentLevel, true);
+	}
+
+	if (GridMapInfo == nullptr)
+		return nullptr;
+
+	Info = GridMapInfo;
+	Data = GridMapInfo->Data.Get();
+
+	// a level built before there was grid data starts off with the tiles it already has,
+	// the data is brand new so recording all of it costs next to nothing
+	UGridMapData* GridMapData = Data.Get();
+	if (bCreated && GridMapData)
+	{
+		GridMapData->Modify();
+
+		for (const TPair<TWeakObjectPtr<AGridMapStaticMeshActor>, FIntVector>& Tile : TileCells)
+		{
+			if (const AGridMapStaticMeshActor* TileActor = Tile.Key.Get())
+			{
+				GridMapData->SetTileSet(Tile.Value, TileActor->TileSet);
+			}
+		}
+
+		for (const TPair<FIntVector, TWeakObjectPtr<AGridMapChunkActor>>& Chunk : Chunks)
+		{
+			const AGridMapChunkActor* ChunkActor = Chunk.Value.Get();
+			if (!IsValid(ChunkActor))
+				continue;
+
+			for (const TPair<FIntVector, FGridMapChunkTile>& Tile : ChunkActor->GetTiles())
+			{
+				GridMapData->SetTileSet(Tile.Key, Tile.Value.TileSet);
+			}
+		}
+	}
+
+	return GridMapInfo;
+}
+
+bool FGridMapCellIndex::IsValidFor(const UWorld* InWorld, int32 InCellSize, int32 InCellHeight) const
+{
+	return bIsValid && World.Get() == InWorld && CellSize == InCellSize && CellHeight == InCellHeight;
+}
+
+void FGridMapCellIndex::Add(AGridMapStaticMeshActor* Tile)
+{
+	if (!bIsValid || Tile == nullptr || Tile->GetWorld() != World.Get())
+		return;
+
+	// if it's already indexed somewhere else, forget about the old cell first
+	Remove(Tile);
+
+	const FIntVector Cell = LocationToCell(Tile->GetActorLocation());
+	Cells.Add(Cell, Tile);
+	TileCells.Add(Tile, Cell);
+	++Revision;
+}
+
+void FGridMapCellIndex::Remove(AGridMapStaticMeshActor* Tile)
+{
+	FIntVector Cell;
+	if (TileCells.RemoveAndCopyValue(Tile, Cell))
+	{
+		++Revision;
+
+		// only clear the cell if it still points at us
+		const TWeakObjectPtr<AGridMapStaticMeshActor>* Existing = Cells.Find(Cell);
+		if (Existing && Existing->Get() == Tile)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+bool FGridMapCellIndex::FindCell(const AGridMapStaticMeshActor* Tile, FIntVector& OutCell) const
+{
+	const FIntVector* Cell = TileCells.Find(Tile);
+	if (Cell == nullptr)
+		return false;
+
+	// another tile may have been put in the cell since, the tile could also be on its way out already
+	const TWeakObjectPtr<AGridMapStaticMeshActor>* Existing = Cells.Find(*Cell);
+	if (Existing == nullptr || Existing->Get(true) != Tile)
+		return false;
+
+	OutCell = *Cell;
+	return true;
+}
+
+AGridMapStaticMeshActor* FGridMapCellIndex::Find(const FIntVector& Cell) const
+{
+	INC_DWORD_STAT(STAT_GridMap_CellQueries);
+
+	const TWeakObjectPtr<AGridMapStaticMeshActor>* Tile = Cells.Find(Cell);
+	if (Tile == nullptr)
+		return nullptr;
+
+	AGridMapStaticMeshActor* TileActor = Tile->Get();
+	return IsValid(TileActor) ? TileActor : nullptr;
+}
+
+void FGridMapCellIndex::AddChunk(AGridMapChunkActor* Chunk)
+{
+	if (!bIsValid || Chunk == nullptr || Chunk->GetWorld() != World.Get())
+		return;
+
+	if (Chunk->GetCellSize() != CellSize || Chunk->GetCellHeight() != CellHeight)
+		return;
+
+	Chunks.Add(Chunk->GetChunkCoord(), Chunk);
+	++Revision;
+}
+
+AGridMapChunkActor* FGridMapCellIndex::GetChunk(const FIntVector& ChunkCoord) const
+{
+	const TWeakObjectPtr<AGridMapChunkActor>* Chunk = Chunks.Find(ChunkCoord);
+	if (Chunk == nullptr)
+		return nullptr;
+
+	AGridMapChunkActor* ChunkActor = Chunk->Get();
+	return IsValid(ChunkActor) ? ChunkActor : nullptr;
+}
+
+AGridMapChunkActor* FGridMapCellIndex::FindChunk(const FIntVector& Cell) const
+{
+	INC_DWORD_STAT(STAT_GridMap_CellQueries);
+
+	AGridMapChunkActor* Chunk = GetChunk(UGridMapData::CellToChunk(Cell));
+	return (Chunk && Chunk->FindTile(Cell)) ? Chunk : nullptr;
+}
+
+UGridMapTileSet* FGridMapCellIndex::GetTileSet(const FIntVector& Cell) const
+{
+	if (const UGridMapData* GridMapData = Data.Get())
+	{
+		INC_DWORD_STAT(STAT_GridMap_CellQueries);
+		return GridMapData->GetTileSet(Cell);
+	}
+
+	if (const AGridMapStaticMeshActor* Tile = Find(Cell))
+		return Tile->TileSet.Get();
+
+	const AGridMapChunkActor* Chunk = FindChunk(Cell);
+	return Chunk ? Chunk->FindTile(Cell)->TileSet.Get() : nullptr;
+}
+
+FIntVector FGridMapCellIndex::LocationToCell(const FVector& Location) const
+{
+	const int32 Size = CellSize > 0 ? CellSize : 1;
+	const int32 Height = CellHeight > 0 ? CellHeight : 1;
+	return FIntVector(
+		FMath::RoundToInt(Location.X / Size),
+		FMath::RoundToInt(Location.Y / Size),
+		FMath::RoundToInt(Location.Z / Height));
+}
+
+FVector FGridMapCellIndex::CellToLocation(const FIntVector& Cell) const
+{
+	const int32 Size = CellSize > 0 ? CellSize : 1;
+	const int32 Height = CellHeight > 0 ? CellHeight : 1;
+	return FVector(Cell.X * Size, Cell.Y * Size, Cell.Z * Height);
+}
+
+void FGridMapCellIndex::GetCellsOnLine(const FIntVector& From, const FIntVector& To, TArray<FIntVector>& OutCells)
+{
+	// Bresenham, but never stepping diagonally, since tiles that only touch
+	// at a corner wouldn't be connected
+	const int32 DeltaX = FMath::Abs(To.X - From.X);
+	const int32 DeltaY = -FMath::Abs(To.Y - From.Y);
+	const int32 StepX = From.X < To.X ? 1 : -1;
+	const int32 StepY = From.Y < To.Y ? 1 : -1;
+
+	int32 Error = DeltaX + DeltaY;
+	FIntVector Cell(From.X, From.Y, To.Z);
+
+	OutCells.Reserve(OutCells.Num() + DeltaX - DeltaY + 1);
+	while (true)
+	{
+		OutCells.Add(Cell);
+		if (Cell.X == To.X && Cell.Y == To.Y)
+			break;
+
+		const int32 DoubleError = 2 * Error;
+		const bool bStepX = DoubleError >= DeltaY;
+		const bool bStepY = DoubleError <= DeltaX;
+		if (bStepX)
+		{
+			Error += DeltaY;
+			Cell.X += StepX;
+		}
+		if (bStepY)
+		{
+			// fill in the corner between the two steps
+			if (bStepX)
+			{
+				OutCells.Add(Cell);
+			}
+
+			Error += DeltaX;
+			Cell.Y += StepY;
+		}
+	}
+}
+
+void FGridMapCellIndex::GetCellsInRectangle(const FIntVector& CornerA, const FIntVector& CornerB, TArray<FIntVector>& OutCells)
+{
+	const FIntVector Min(FMath::Min(CornerA.X, CornerB.X), FMath::Min(CornerA.Y, CornerB.Y), CornerB.Z);
+	const FIntVector Max(FMath::Max(CornerA.X, CornerB.X), FMath::Max(CornerA.Y, CornerB.Y), CornerB.Z);
+
+	OutCells.Reserve(OutCells.Num() + (Max.X - Min.X + 1) * (Max.Y - Min.Y + 1));
+	for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+	{
+		for (int32 X = Min.X; X <= Max.X; ++X)
+		{
+			OutCells.Add(FIntVector(X, Y, Min.Z));
+		}
+	}
+}
+
+bool FGridMapCellIndex::GetBounds(int32 Z, FIntVector& OutMin, FIntVector& OutMax) const
+{
+	bool bFoundAny = false;
+	auto AddCell = [&bFoundAny, &OutMin, &OutMax](const FIntVector& Cell)
+	{
+		if (!bFoundAny)
+		{
+			OutMin = Cell;
+			OutMax = Cell;
+			bFoundAny = true;
+			return;
+		}
+
+		OutMin.X = FMath::Min(OutMin.X, Cell.X);
+		OutMin.Y = FMath::Min(OutMin.Y, Cell.Y);
+		OutMax.X = FMath::Max(OutMax.X, Cell.X);
+		OutMax.Y = FMath::Max(OutMax.Y, Cell.Y);
+	};
+
+	// the grid data has the instanced cells as well as the tile actors' ones
+	if (const UGridMapData* GridMapData = Data.Get())
+	{
+		for (const FGridMapDataChunk& Chunk : GridMapData->GetChunks())
+		{
+			if (Chunk.ChunkCoord.Z != Z || Chunk.NumTiles == 0)
+				continue;
+
+			for (int32 ChunkIndex = 0; ChunkIndex < UGridMapData::CellsPerChunk; ++ChunkIndex)
+			{
+				if (Chunk.TileSetIds[ChunkIndex] != 0)
+				{
+					AddCell(UGridMapData::ChunkIndexToCell(Chunk.ChunkCoord, ChunkIndex));
+				}
+			}
+		}
+		return bFoundAny;
+	}
+
+	for (const TPair<FIntVector, TWeakObjectPtr<AGridMapStaticMeshActor>>& Cell : Cells)
+	{
+		if (Cell.Key.Z == Z)
+		{
+			AddCell(Cell.Key);
+		}
+	}
+
+	return bFoundAny;
+}
+
+bool FGridMapCellIndex::GetConnectedCells(const FIntVector& Start, const FIntVector& MinCell, const FIntVector& MaxCell, TArray<FIntVector>& OutCells) const
+{
+	static const FIntVector Offsets[4]{
+		FIntVector(0, -1, 0),
+		FIntVector(-1, 0, 0),
+		FIntVector(1, 0, 0),
+		FIntVector(0, 1, 0),
+	};
+
+	auto IsInBounds = [&MinCell, &MaxCell](const FIntVector& Cell)
+	{
+		return Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y;
+	};
+
+	if (!IsInBounds(Start))
+		return false;
+
+	const UGridMapTileSet* StartTileSet = GetTileSet(Start);
+
+	TSet<FIntVector> Visited;
+	Visited.Add(Start);
+	OutCells.Add(Start);
+
+	// OutCells doubles as the work list
+	for (int32 CellIndex = OutCells.Num() - 1; CellIndex < OutCells.Num(); ++CellIndex)
+	{
+		const FIntVector Cell = OutCells[CellIndex];
+		for (const FIntVector& Offset : Offsets)
+		{
+			const FIntVector Neighbour = Cell + Offset;
+			if (Visited.Contains(Neighbour) || GetTileSet(Neighbour) != StartTileSet)
+				continue;
+
+			// it leaks out, ie. an empty area that isn't closed off
+			if (!IsInBounds(Neighbour))
+				return false;
+
+			Visited.Add(Neighbour);
+			OutCells.Add(Neighbour);
+		}
+	}
+
+	return true;
+}
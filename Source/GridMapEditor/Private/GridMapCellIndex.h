@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AGridMapChunkActor;
+class AGridMapInfo;
+class AGridMapStaticMeshActor;
+class FGridMapTilePool;
+class UGridMapData;
+class UGridMapTileSet;
+class UWorld;
+
+/**
+ * Sparse lookup from integer grid cells to the tile actor or chunk instance occupying them.
+ * Replaces physics overlap queries when looking for tiles at a location.
+ * Only covers the view, what's in each cell comes from the level's grid data.
+ */
+class FGridMapCellIndex
+{
+public:
+	FGridMapCellIndex();
+
+	/**
+	 * Rebuilds the index from every tile actor and chunk actor in the world, the grid data is left as it is.
+	 * Tiles sitting in the pool aren't part of the map and are left out.
+	 */
+	void Rebuild(UWorld* InWorld, int32 InCellSize, int32 InCellHeight, const FGridMapTilePool* Pool = nullptr);
+
+	/** Marks the index as stale, it'll be rebuilt on next use */
+	void Invalidate() { bIsValid = false; Info.Reset(); Data.Reset(); ++Revision; }
+
+	/** True if the index is up to date for the given world and cell dimensions */
+	bool IsValidFor(const UWorld* InWorld, int32 InCellSize, int32 InCellHeight) const;
+
+	void Add(AGridMapStaticMeshActor* Tile);
+	void Remove(AGridMapStaticMeshActor* Tile);
+
+	AGridMapStaticMeshActor* Find(const FIntVector& Cell) const;
+
+	/** Indexes a chunk actor spawned after the last rebuild, chunks with other cell dimensions are ignored */
+	void AddChunk(AGridMapChunkActor* Chunk);
+
+	/** The chunk actor covering the chunk, whether or not it has any of the chunk's cells instanced */
+	AGridMapChunkActor* GetChunk(const FIntVector& ChunkCoord) const;
+
+	/** The chunk actor with an instance in the cell, null if the cell isn't instanced */
+	AGridMapChunkActor* FindChunk(const FIntVector& Cell) const;
+
+	/** The cell the tile was indexed in, which is where it was when it was last added, false if another tile has taken it since */
+	bool FindCell(const AGridMapStaticMeshActor* Tile, FIntVector& OutCell) const;
+
+	/** Every indexed tile actor and its cell, which may include some that were destroyed since */
+	const TMap<TWeakObjectPtr<AGridMapStaticMeshActor>, FIntVector>& GetTiles() const { return TileCells; }
+
+	/** The tile set in the cell according to the grid data, or the tile or instance in it if the level has none yet */
+	UGridMapTileSet* GetTileSet(const FIntVector& Cell) const;
+
+	/** The grid data of the world's persistent level, null until the level's first grid map edit */
+	UGridMapData* GetData() const { return Data.Get(); }
+
+	/** The persistent level's grid map info, looked up once per rebuild instead of on every call */
+	AGridMapInfo* GetInfo() const { return Info.Get(); }
+	/** Only for edits, a new info is spawned into the level inside the edit's transaction and filled in from the tiles it already has */
+	AGridMapInfo* FindOrCreateInfo();
+
+	FIntVector LocationToCell(const FVector& Location) const;
+	FVector CellToLocation(const FIntVector& Cell) const;
+
+	/** Every cell on the line between the two cells (inclusive) on the XY plane, each one sharing an edge with the next */
+	static void GetCellsOnLine(const FIntVector& From, const FIntVector& To, TArray<FIntVector>& OutCells);
+
+	/** Every cell in the rectangle spanned by the two corner cells (inclusive) on the XY plane */
+	static void GetCellsInRectangle(const FIntVector& CornerA, const FIntVector& CornerB, TArray<FIntVector>& OutCells);
+
+	/** The XY extents of all cells on the given Z level according to the grid data (or the tile actors if there isn't any), false if there aren't any */
+	bool GetBounds(int32 Z, FIntVector& OutMin, FIntVector& OutMax) const;
+
+	/**
+	 * Gathers the cells connected to Start (sharing an edge) that hold the same tile set as Start,
+	 * or are empty if Start is. Returns false if the region runs past the given bounds.
+	 */
+	bool GetConnectedCells(const FIntVector& Start, const FIntVector& MinCell, const FIntVector& MaxCell, TArray<FIntVector>& OutCells) const;
+
+	/** Bumped whenever the index changes, so callers can tell if something they cached is stale */
+	uint32 GetRevision() const { return Revision; }
+
+	int32 GetCellSize() const { return CellSize; }
+	int32 GetCellHeight() const { return CellHeight; }
+	int32 Num() const { return Cells.Num(); }
+
+private:
+	TWeakObjectPtr<UWorld> World;
+	TWeakObjectPtr<AGridMapInfo> Info;
+	TWeakObjectPtr<UGridMapData> Data;
+	int32 CellSize;
+	/** Cells are stacked by the tile height, which needn't match their width */
+	int32 CellHeight;
+	bool bIsValid;
+	uint32 Revision;
+
+	TMap<FIntVector, TWeakObjectPtr<AGridMapStaticMeshActor>> Cells;
+
+	// reverse lookup, so tiles can be removed after they've moved
+	TMap<TWeakObjectPtr<AGridMapStaticMeshActor>, FIntVector> TileCells;
+
+	/** Chunk actors by chunk coordinate, they never move so there's no reverse lookup */
+	TMap<FIntVector, TWeakObjectPtr<AGridMapChunkActor>> Chunks;
+};
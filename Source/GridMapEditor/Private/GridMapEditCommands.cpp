@@ -17,12 +17,14 @@ void FGridMapEditCommands::RegisterCommands()
 {
 	MakeUICommand(SetPaintTiles, TEXT("PaintTiles"), LOCTEXT("Paint", "Paint"), LOCTEXT("PaintDescription", "Paint Tiles"), EUserInterfaceActionType::ToggleButton);
 	MakeUICommand(SetSelectTiles, TEXT("SelectTiles"), LOCTEXT("Select", "Select"), LOCTEXT("SelectDescription", "Select Tiles"), EUserInterfaceActionType::ToggleButton);
+	MakeUICommand(SetRectangleTiles, TEXT("RectangleTiles"), LOCTEXT("Rectangle", "Rectangle"), LOCTEXT("RectangleDescription", "Paint a rectangle of tiles"), EUserInterfaceActionType::ToggleButton);
+	MakeUICommand(SetLineTiles, TEXT("LineTiles"), LOCTEXT("Line", "Line"), LOCTEXT("LineDescription", "Paint a line of tiles"), EUserInterfaceActionType::ToggleButton);
+	MakeUICommand(SetFillTiles, TEXT("FillTiles"), LOCTEXT("Fill", "Fill"), LOCTEXT("FillDescription", "Fill an enclosed area, or replace a connected area of the same tiles"), EUserInterfaceActionType::ToggleButton);
 	MakeUICommand(SetTileSettings, TEXT("TileSettings"), LOCTEXT("Settings", "Settings"), LOCTEXT("SettingDescription", "Configuration"), EUserInterfaceActionType::ToggleButton);
 	/*
 	UI_COMMAND(SetReapplySettings, "Reapply", "Reapply settings to instances", EUserInterfaceActionType::ToggleButton, FInputChord());
 	UI_COMMAND(SetSelect, "Select", "Select", EUserInterfaceActionType::ToggleButton, FInputChord());
 	UI_COMMAND(SetLassoSelect, "Lasso", "Lasso Select", EUserInterfaceActionType::ToggleButton, FInputChord());
-	UI_COMMAND(SetPaintBucket, "Fill", "Paint Bucket", EUserInterfaceActionType::ToggleButton, FInputChord());
 	*/
 }
 
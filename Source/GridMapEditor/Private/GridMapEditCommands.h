@@ -16,11 +16,13 @@ public:
 	TSharedPtr<FUICommandInfo> SetPaintTiles;
 	TSharedPtr<FUICommandInfo> SetSelectTiles;
 	TSharedPtr<FUICommandInfo> SetTileSettings;
+	TSharedPtr<FUICommandInfo> SetRectangleTiles;
+	TSharedPtr<FUICommandInfo> SetLineTiles;
+	TSharedPtr<FUICommandInfo> SetFillTiles;
 
 	/*
 	TSharedPtr< FUICommandInfo > SetReapplySettings;	
 	TSharedPtr< FUICommandInfo > SetLassoSelect;
-	TSharedPtr< FUICommandInfo > SetPaintBucket;
 	*/
 
 	/**
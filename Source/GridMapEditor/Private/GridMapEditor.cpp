@@ -2,11 +2,14 @@
 
 #include "GridMapEditor.h"
 #include "AssetToolsModule.h"
+#include "Editor.h"
 #include "GridMapEditCommands.h"
 #include "GridMapEditorMode.h"
 #include "GridMapTileSetAssetTypeActions.h"
 #include "GridMapStyleSet.h"
+#include "GridMapViewSync.h"
 #include "Interfaces/IPluginManager.h"
+#include "Misc/CoreDelegates.h"
 #include "PropertyEditorModule.h"
 #include "Styling/SlateStyleRegistry.h"
 #include "ThumbnailRendering/ThumbnailManager.h"
@@ -16,6 +19,8 @@
 
 #define LOCTEXT_NAMESPACE "FGridMapEditorModule"
 
+DEFINE_LOG_CATEGORY(LogGridMapEditor);
+
 // This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 void FGridMapEditorModule::StartupModule()
 {
@@ -38,12 +43,26 @@ void FGridMapEditorModule::StartupModule()
 	// Modes
 	FEditorModeRegistry::Get().RegisterMode<FGridMapEditorMode>(FGridMapEditorMode::EM_GridMapEditorModeId, LOCTEXT("GridMapEditorModeName", "GridMapEditorMode"), FSlateIcon("GridMapStyle", "GridMapEditor.Tab", "GridMapEditor.Tab.Small"), true);
 	FGridMapEditCommands::Register();
+
+	// hand edits to tiles outside the mode still have to reach the grid data, the editor isn't up yet
+	FCoreDelegates::OnPostEngineInit.AddRaw(this, &FGridMapEditorModule::OnPostEngineInit);
+}
+
+void FGridMapEditorModule::OnPostEngineInit()
+{
+	if (GEditor && !IsRunningCommandlet())
+	{
+		ViewSync = MakeUnique<FGridMapViewSync>();
+	}
 }
 
 // This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 // we call this function before unloading the module.
 void FGridMapEditorModule::ShutdownModule()
 {	
+	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+	ViewSync.Reset();
+
 	FEditorModeRegistry::Get().UnregisterMode(FGridMapEditorMode::EM_GridMapEditorModeId);
 
 	if (FModuleManager::Get().IsModuleLoaded("PropertyEditor"))
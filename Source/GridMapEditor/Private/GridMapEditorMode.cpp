@@ -1,7 +1,9 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "GridMapEditorMode.h"
+#include "Components/InstancedStaticMeshComponent.h"
 #include "DrawDebugHelpers.h"
+#include "Editor.h"
 #include "EditorModeManager.h"
 #include "EditorViewportClient.h"
 #include "EngineUtils.h"
@@ -10,20 +12,40 @@
 #include "Engine/EngineTypes.h"
 #include "Engine/World.h"
 #include "Framework/Commands/UICommandList.h"
+#include "GridMapChunkActor.h"
+#include "GridMapData.h"
 #include "GridMapEditCommands.h"
+#include "GridMapEditor.h"
 #include "GridMapEditorModeToolkit.h"
+#include "GridMapInfo.h"
+#include "GridMapRebuild.h"
 #include "GridMapStaticMeshActor.h"
-#include "Kismet/KismetSystemLibrary.h"
+#include "GridMapStats.h"
+#include "GridMapTilePool.h"
+#include "GridMapTileSetCompatibility.h"
+#include "GridMapViewSync.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ScopedTransaction.h"
 #include "TileSet.h"
 #include "Toolkits/ToolkitManager.h"
 
+#define LOCTEXT_NAMESPACE "GridMapEditor"
+
+DECLARE_CYCLE_STAT(TEXT("Brush Trace"), STAT_GridMap_BrushTrace, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Paint Tile"), STAT_GridMap_PaintTile, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Commit Stroke"), STAT_GridMap_CommitStroke, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Tile Preview"), STAT_GridMap_TilePreview, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Tiles At"), STAT_GridMap_TilesAt, STATGROUP_GridMap);
+
 static FName GridMapBrushHighlightColorParamName("HighlightColor");
 
 const FEditorModeID FGridMapEditorMode::EM_GridMapEditorModeId = TEXT("EM_GridMapEditorMode");
 
 FGridMapEditorMode::FGridMapEditorMode()
 	: FEdMode()
+	, bTransactEdits(true)
+	, TilePool(FGridMapTilePool::Get())
 	, ActiveTileSet(nullptr)
 {
 	BrushDefaultHighlightColor = FColor(127, 127, 255, 255);
@@ -51,8 +73,20 @@ FGridMapEditorMode::FGridMapEditorMode()
 	TileBrushComponent->SetAbsolute(true, true, true);
 	TileBrushComponent->CastShadow = false;
 
+	StrokePreviewComponent = NewObject<UInstancedStaticMeshComponent>(GetTransientPackage(), TEXT("StrokePreviewComponent"));
+	StrokePreviewComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	StrokePreviewComponent->SetStaticMesh(StaticMesh);
+	StrokePreviewComponent->SetMaterial(0, BrushMID);
+	StrokePreviewComponent->SetAbsolute(true, true, true);
+	StrokePreviewComponent->CastShadow = false;
+
+	// Tiles show the brush cube until their mesh has streamed in
+	MeshStreamer.SetPlaceholderMesh(StaticMesh);
+
 	bBrushTraceValid = false;
 	BrushLocation = FVector::ZeroVector;
+	BrushTraceRevision = 0;
+	TilePreviewRevision = 0;
 
 	// Setup and bind commands
 	UICommandList = MakeShareable(new FUICommandList);
@@ -86,6 +120,33 @@ void FGridMapEditorMode::BindCommandList()
 			return UISettings.GetSelectToolSelected();
 		}));
 
+	UICommandList->MapAction(
+		Commands.SetRectangleTiles,
+		FExecuteAction::CreateRaw(this, &FGridMapEditorMode::OnSetRectangleTiles),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateLambda([=]
+		{
+			return UISettings.GetRectangleToolSelected();
+		}));
+
+	UICommandList->MapAction(
+		Commands.SetLineTiles,
+		FExecuteAction::CreateRaw(this, &FGridMapEditorMode::OnSetLineTiles),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateLambda([=]
+		{
+			return UISettings.GetLineToolSelected();
+		}));
+
+	UICommandList->MapAction(
+		Commands.SetFillTiles,
+		FExecuteAction::CreateRaw(this, &FGridMapEditorMode::OnSetFillTiles),
+		FCanExecuteAction(),
+		FIsActionChecked::CreateLambda([=]
+		{
+			return UISettings.GetFillToolSelected();
+		}));
+
 	UICommandList->MapAction(
 		Commands.SetTileSettings,
 		FExecuteAction::CreateRaw(this, &FGridMapEditorMode::OnSetTileSettings),
@@ -113,6 +174,22 @@ void FGridMapEditorMode::Enter()
 
 	const bool bNewVisibility(true);
 	TileBrushComponent->SetVisibility(bNewVisibility);
+
+	// Keep the cell index in sync with the level
+	CellIndex.Invalidate();
+	GEditor->RegisterForUndo(this);
+	OnLevelActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FGridMapEditorMode::OnLevelActorAdded);
+	OnLevelActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FGridMapEditorMode::OnLevelActorDeleted);
+	OnActorMovedHandle = GEngine->OnActorMoved().AddRaw(this, &FGridMapEditorMode::OnActorMoved);
+	OnMapChangedHandle = FEditorDelegates::MapChange.AddRaw(this, &FGridMapEditorMode::OnMapChanged);
+	OnLevelAddedToWorldHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FGridMapEditorMode::OnLevelAddedOrRemoved);
+	OnLevelRemovedFromWorldHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FGridMapEditorMode::OnLevelAddedOrRemoved);
+	OnMapSeedChangedHandle = AGridMapInfo::OnSeedChanged.AddRaw(this, &FGridMapEditorMode::OnMapSeedChanged);
+	OnCellsRestoredHandle = FGridMapCellChange::OnCellsRestored.AddRaw(this, &FGridMapEditorMode::OnCellsRestored);
+	OnPreSaveWorldHandle = FEditorDelegates::PreSaveWorldWithContext.AddRaw(this, &FGridMapEditorMode::OnPreSaveWorld);
+
+	// Once per frame, not once per viewport, and regardless of whether editing is allowed right now
+	TimeSlicedRebuildTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FGridMapEditorMode::TickTimeSlicedRebuild));
 }
 
 void FGridMapEditorMode::Exit()
@@ -123,8 +200,36 @@ void FGridMapEditorMode::Exit()
 		Toolkit.Reset();
 	}
 
+	// Don't lose a stroke that's still in progress
+	CommitStroke();
+
+	// Whatever was rebuilt so far stays, the rest of the map is left as it was
+	FTSTicker::GetCoreTicker().RemoveTicker(TimeSlicedRebuildTickerHandle);
+	TimeSlicedRebuildTickerHandle.Reset();
+	TimeSlicedRebuild.Cancel();
+
 	// Remove the brush
 	TileBrushComponent->UnregisterComponent();
+	HideTilePreview();
+
+	// Nothing will tick the streamer once we're gone, finish any pending tiles
+	MeshStreamer.FlushRequestsSynchronous();
+
+	// Pooled tiles stay parked for next time and for undo, they're transient so they're never saved
+
+	// Stop tracking level changes
+	GEditor->UnregisterForUndo(this);
+	GEngine->OnLevelActorAdded().Remove(OnLevelActorAddedHandle);
+	GEngine->OnLevelActorDeleted().Remove(OnLevelActorDeletedHandle);
+	GEngine->OnActorMoved().Remove(OnActorMovedHandle);
+	FEditorDelegates::MapChange.Remove(OnMapChangedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(OnLevelAddedToWorldHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(OnLevelRemovedFromWorldHandle);
+	AGridMapInfo::OnSeedChanged.Remove(OnMapSeedChangedHandle);
+	FGridMapCellChange::OnCellsRestored.Remove(OnCellsRestoredHandle);
+	FEditorDelegates::PreSaveWorldWithContext.Remove(OnPreSaveWorldHandle);
+	RestoredCells.Reset();
+	CellIndex.Invalidate();
 
 	// Call base Exit method to ensure proper cleanup
 	FEdMode::Exit();
@@ -132,6 +237,9 @@ void FGridMapEditorMode::Exit()
 
 void FGridMapEditorMode::Tick(FEditorViewportClient* ViewportClient, float DeltaTime)
 {
+	// Send off everything that was queued up this frame as one batch
+	MeshStreamer.FlushRequests();
+
 	if (!IsEditingEnabled())
 		return;
 
@@ -158,6 +266,16 @@ void FGridMapEditorMode::Tick(FEditorViewportClient* ViewportClient, float Delta
 		{
 			TileBrushComponent->RegisterComponentWithWorld(ViewportClient->GetWorld());
 		}
+
+		// the stroke has its own preview while dragging
+		if (bIsPainting)
+		{
+			HideTilePreview();
+		}
+		else
+		{
+			UpdateTilePreview(ViewportClient->GetWorld());
+		}
 	}
 	else
 	{
@@ -165,6 +283,7 @@ void FGridMapEditorMode::Tick(FEditorViewportClient* ViewportClient, float Delta
 		{
 			TileBrushComponent->UnregisterComponent();
 		}
+		HideTilePreview();
 	}
 
 }
@@ -178,6 +297,8 @@ void FGridMapEditorMode::AddReferencedObjects(FReferenceCollector& Collector)
 {
 	FEdMode::AddReferencedObjects(Collector);
 	Collector.AddReferencedObject(TileBrushComponent);
+	Collector.AddReferencedObject(StrokePreviewComponent);
+	Collector.AddReferencedObjects(TilePreviewComponents);
 }
 
 bool FGridMapEditorMode::StartTracking(FEditorViewportClient* InViewportClient, FViewport* InViewport)
@@ -187,6 +308,7 @@ bool FGridMapEditorMode::StartTracking(FEditorViewportClient* InViewportClient,
 
 bool FGridMapEditorMode::EndTracking(FEditorViewportClient* InViewportClient, FViewport* InViewport)
 {
+	CommitStroke();
 	return FEdMode::EndTracking(InViewportClient, InViewport);
 }
 
@@ -237,90 +359,414 @@ bool FGridMapEditorMode::CapturedMouseMove(FEditorViewportClient* InViewportClie
 
 	GridMapBrushTrace(InViewportClient, BrushTraceStart, BrushTraceDirection);
 
-	PaintTile();
+	UpdateStroke();
 	return true;
 }
 
+void FGridMapEditorMode::UpdateStroke()
+{
+	if (UISettings.GetRectangleToolSelected() || UISettings.GetLineToolSelected())
+	{
+		RecordShapeStroke();
+	}
+	else if (UISettings.GetFillToolSelected())
+	{
+		RecordFillStroke();
+	}
+	else if (UISettings.GetBatchStrokes())
+	{
+		RecordStrokeCell();
+	}
+	else
+	{
+		PaintTile();
+	}
+}
+
 void FGridMapEditorMode::PaintTile()
 {
-	// are we erasing?
-	if (bIsPainting && bBrushTraceValid && UISettings.GetPaintMode() == EGridMapPaintMode::Erase && UISettings.GetCurrentTileSet().IsValid())
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_PaintTile);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_PaintTile);
+
+	if (!bIsPainting || !bBrushTraceValid || !UISettings.GetCurrentTileSet().IsValid())
+		return;
+
+	UWorld* World = GetWorld();
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+	const FIntVector Cell = Index.LocationToCell(BrushLocation);
+	const UGridMapTileSet* ExistingTileSet = Index.GetTileSet(Cell);
+
+	UGridMapTileSet* TileSet = nullptr;
+	if (UISettings.GetPaintMode() == EGridMapPaintMode::Erase)
+	{
+		// nothing to erase
+		if (ExistingTileSet == nullptr)
+			return;
+	}
+	else
 	{
-		// and we're on top of something?
-		if (BrushTraceHitActor.IsValid() && Cast<AGridMapStaticMeshActor>(BrushTraceHitActor.Get()))
+		TileSet = UISettings.GetCurrentTileSet().Get();
+
+		// if it's the same tile set, don't do anything
+		if (ExistingTileSet && TileSet->TileTags.HasAllExact(ExistingTileSet->TileTags))
+			return;
+
+		// nothing fits here, whatever was in the cell goes
+		if (TileSet->FindTilesForAdjacency(GetTileAdjacencyBitmask(World, BrushLocation, TileSet)) == nullptr)
 		{
-			EraseTile(Cast<AGridMapStaticMeshActor>(BrushTraceHitActor.Get()));
-			BrushTraceHitActor.Reset();
+			if (ExistingTileSet == nullptr)
+				return;
+
+			TileSet = nullptr;
 		}
+	}
+
+	// only the cells around it can change
+	TSet<FIntVector> ChangedCells;
+	FGridMapRebuild::AddCellAndNeighbours(Cell, ChangedCells);
+	CaptureCellStates(World, ChangedCells);
+
+	SetCellTileSet(Cell, TileSet);
+	BrushTraceHitActor.Reset();
+
+	ResolveCells(World, ChangedCells);
+}
+
+void FGridMapEditorMode::RecordStrokeCell()
+{
+	if (!bIsPainting || !bBrushTraceValid || !UISettings.GetCurrentTileSet().IsValid())
 		return;
+
+	const FIntVector Cell = GetCellIndex(GetWorld()).LocationToCell(BrushLocation);
+	if (LastStrokeCell.IsSet() && LastStrokeCell.GetValue() != Cell)
+	{
+		// the mouse can skip over cells when it moves quickly, so walk every cell since the last event
+		TArray<FIntVector> LineCells;
+		FGridMapCellIndex::GetCellsOnLine(LastStrokeCell.GetValue(), Cell, LineCells);
+		for (const FIntVector& LineCell : LineCells)
+		{
+			RecordStrokeCellAt(LineCell);
+		}
 	}
+	else
+	{
+		RecordStrokeCellAt(Cell);
+	}
+
+	LastStrokeCell = Cell;
+}
+
+void FGridMapEditorMode::RecordShapeStroke()
+{
+	if (!bIsPainting || !bBrushTraceValid || !UISettings.GetCurrentTileSet().IsValid())
+		return;
+
+	const FIntVector Cell = GetCellIndex(GetWorld()).LocationToCell(BrushLocation);
+	if (!StrokeAnchorCell.IsSet())
+	{
+		StrokeAnchorCell = Cell;
+	}
+	else if (LastStrokeCell.IsSet() && LastStrokeCell.GetValue() == Cell)
+	{
+		return;
+	}
+
+	// the shape follows the mouse, so start over from the anchor each time
+	ClearStrokeCells();
+
+	TArray<FIntVector> ShapeCells;
+	if (UISettings.GetRectangleToolSelected())
+	{
+		FGridMapCellIndex::GetCellsInRectangle(StrokeAnchorCell.GetValue(), Cell, ShapeCells);
+	}
+	else
+	{
+		FGridMapCellIndex::GetCellsOnLine(StrokeAnchorCell.GetValue(), Cell, ShapeCells);
+	}
+
+	for (const FIntVector& ShapeCell : ShapeCells)
+	{
+		RecordStrokeCellAt(ShapeCell);
+	}
+
+	LastStrokeCell = Cell;
+}
+
+void FGridMapEditorMode::RecordFillStroke()
+{
+	// one fill per click
+	if (!bIsPainting || !bBrushTraceValid || !UISettings.GetCurrentTileSet().IsValid() || StrokeAnchorCell.IsSet())
+		return;
+
+	const FGridMapCellIndex& Index = GetCellIndex(GetWorld());
+	const FIntVector Cell = Index.LocationToCell(BrushLocation);
+	StrokeAnchorCell = Cell;
+
+	// empty space only counts if it's closed off by tiles, otherwise the fill would never stop
+	FIntVector MinCell, MaxCell;
+	TArray<FIntVector> FillCells;
+	if (!Index.GetBounds(Cell.Z, MinCell, MaxCell) || !Index.GetConnectedCells(Cell, MinCell, MaxCell, FillCells))
+	{
+		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 4.0f, FColor::Red, TEXT("Nothing to fill, the area isn't enclosed by tiles!"), true, FVector2D::UnitVector);
+		return;
+	}
+
+	for (const FIntVector& FillCell : FillCells)
+	{
+		RecordStrokeCellAt(FillCell);
+	}
+}
+
+void FGridMapEditorMode::ClearStrokeCells()
+{
+	StrokeCells.Reset();
+	if (StrokePreviewComponent->IsRegistered())
+	{
+		StrokePreviewComponent->ClearInstances();
+	}
+}
+
+void FGridMapEditorMode::RecordStrokeCellAt(const FIntVector& Cell)
+{
+	if (StrokeCells.Contains(Cell))
+		return;
+
+	UWorld* World = GetWorld();
+	const FGridMapCellIndex& Index = GetCellIndex(World);
 
-	// if we're painting, 
-	if (bIsPainting && bBrushTraceValid && UISettings.GetCurrentTileSet().IsValid())
+	UGridMapTileSet* TileSet = nullptr;
+	const UGridMapTileSet* ExistingTileSet = Index.GetTileSet(Cell);
+	if (UISettings.GetPaintMode() == EGridMapPaintMode::Erase)
+	{
+		// nothing to erase
+		if (ExistingTileSet == nullptr)
+			return;
+	}
+	else
 	{
-		UGridMapTileSet* TileSet = UISettings.GetCurrentTileSet().Get();
+		TileSet = UISettings.GetCurrentTileSet().Get();
 
 		// if it's the same tile set, don't do anything
-		if (BrushTraceHitActor.IsValid())
+		if (ExistingTileSet && TileSet->TileTags.HasAllExact(ExistingTileSet->TileTags))
+			return;
+	}
+
+	StrokeCells.Add(Cell, TileSet);
+
+	if (!StrokePreviewComponent->IsRegistered())
+	{
+		StrokePreviewComponent->RegisterComponentWithWorld(World);
+	}
+	StrokePreviewComponent->AddInstance(FTransform(Index.CellToLocation(Cell)));
+}
+
+void FGridMapEditorMode::CommitStroke()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_CommitStroke);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_CommitStroke);
+
+	if (StrokePreviewComponent->IsRegistered())
+	{
+		StrokePreviewComponent->ClearInstances();
+		StrokePreviewComponent->UnregisterComponent();
+	}
+
+	LastStrokeCell.Reset();
+	StrokeAnchorCell.Reset();
+
+	UWorld* World = GetWorld();
+	if (StrokeCells.Num() > 0)
+	{
+		TSet<FIntVector> DirtyCells;
+		for (const TPair<FIntVector, TWeakObjectPtr<UGridMapTileSet>>& StrokeCell : StrokeCells)
 		{
-			AGridMapStaticMeshActor* BrushTraceHitTile = Cast<AGridMapStaticMeshActor>(BrushTraceHitActor.Get());
-			if (BrushTraceHitTile && BrushTraceHitTile->TileSet && TileSet->TileTags.HasAllExact(BrushTraceHitTile->TileSet->TileTags))
-				return;
+			FGridMapRebuild::AddCellAndNeighbours(StrokeCell.Key, DirtyCells);
 		}
+		CaptureCellStates(World, DirtyCells);
 
-		// we're about to replace an actor
-		if (BrushTraceHitActor.IsValid())
+		// change every cell first, so each tile only has to be resolved once against its final neighbours
+		for (const TPair<FIntVector, TWeakObjectPtr<UGridMapTileSet>>& StrokeCell : StrokeCells)
 		{
-			EraseTile(Cast<AGridMapStaticMeshActor>(BrushTraceHitActor.Get()));
-			BrushTraceHitActor.Reset();
+			SetCellTileSet(StrokeCell.Key, StrokeCell.Value.Get());
 		}
-		
-		// figure out the bitmask for this tile
-		uint32 Adjacency = GetTileAdjacencyBitmask(GetWorld(), BrushLocation, TileSet);
-		const FGridMapTileList* TileList = TileSet->FindTilesForAdjacency(Adjacency);
-		if (TileList)
+		StrokeCells.Reset();
+		BrushTraceHitActor.Reset();
+
+		ResolveCells(World, DirtyCells);
+	}
+
+	// the unbatched path records its cells as it goes, so this covers both
+	StoreCellChange(World);
+}
+
+void FGridMapEditorMode::CaptureCellStates(UWorld* World, const TSet<FIntVector>& Cells)
+{
+	// tiles spawned and released from here on belong to this edit
+	BeginEdit(World);
+
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+	for (const FIntVector& Cell : Cells)
+	{
+		// the first capture in a stroke is the one to go back to
+		if (!PendingCellStates.Contains(Cell))
 		{
-			TSoftObjectPtr<UStaticMesh> StaticMeshAsset = TileList->GetRandomTile();
+			PendingCellStates.Add(Cell, FGridMapCellChange::GetCellState(Index.GetData(), Cell));
+		}
+	}
+}
 
-			FActorSpawnParameters SpawnParameters;
-			if (UISettings.GetHideOwnedActors())
-			{
-				SpawnParameters.bHideFromSceneOutliner = true;
-			}
-			AGridMapStaticMeshActor* MeshActor = GetWorld()->SpawnActor<AGridMapStaticMeshActor>(SpawnParameters);
-			MeshActor->TileSet = TileSet;
+void FGridMapEditorMode::BeginEdit(UWorld* World)
+{
+	if (EditTransaction.IsValid())
+		return;
 
-			// Rename the display name of the new actor in the editor to reflect the mesh that is being created from.
-			FActorLabelUtilities::SetActorLabelUnique(MeshActor, CreateActorLabel(TileSet));
+	const FText Description = UISettings.GetPaintMode() == EGridMapPaintMode::Erase ? LOCTEXT("EraseTilesTransaction", "Erase Tiles") : LOCTEXT("PaintTilesTransaction", "Paint Tiles");
+	EditTransaction = MakeUnique<FScopedTransaction>(Description, bTransactEdits);
 
-			UStaticMesh* StaticMesh = Cast<UStaticMesh>(StaticMeshAsset.LoadSynchronous());
-			MeshActor->GetStaticMeshComponent()->SetStaticMesh(StaticMesh);
-			MeshActor->ReregisterAllComponents();
+	// the level's first edit is what gives it grid data
+	GetCellIndex(World);
+	CellIndex.FindOrCreateInfo();
+}
 
-			FTransform BrushTransform = FTransform(TileList->Rotation.Quaternion(), BrushLocation, FVector::OneVector);
-			MeshActor->SetActorTransform(BrushTransform);
+void FGridMapEditorMode::StoreCellChange(UWorld* World)
+{
+	if (PendingCellStates.Num() > 0)
+	{
+		const FGridMapCellIndex& Index = GetCellIndex(World);
 
-			// update adjacent tiles
-			TArray<FAdjacentTile> AdjacentTiles;
-			if (GetAdjacentTiles(GetWorld(), BrushLocation, AdjacentTiles))
+		TArray<FGridMapCellDelta> Deltas;
+		for (const TPair<FIntVector, FGridMapCellState>& PendingCellState : PendingCellStates)
+		{
+			FGridMapCellState After = FGridMapCellChange::GetCellState(Index.GetData(), PendingCellState.Key);
+			if (After != PendingCellState.Value)
 			{
-				UpdateAdjacentTiles(GetWorld(), AdjacentTiles);
+				Deltas.Add({ PendingCellState.Key, PendingCellState.Value, MoveTemp(After) });
 			}
 		}
+		PendingCellStates.Reset();
+
+		// the tile actors aren't recorded, undo syncs them from these cells
+		UGridMapData* GridMapData = Index.GetData();
+		if (Deltas.Num() > 0 && GridMapData && GUndo)
+		{
+			GUndo->StoreUndo(GridMapData, MakeUnique<FGridMapCellChange>(MoveTemp(Deltas)));
+		}
 	}
+
+	// an edit that didn't change anything leaves an empty transaction, which is thrown away
+	EditTransaction.Reset();
 }
 
-void FGridMapEditorMode::EraseTile(AGridMapStaticMeshActor* TileToErase)
+void FGridMapEditorMode::ResolveCells(UWorld* World, const TSet<FIntVector>& Cells, bool bResolveUnchanged)
 {
-	TArray<FAdjacentTile> AdjacentTiles;
-	bool hasAdjacentTiles = GetAdjacentTiles(GetWorld(), TileToErase->GetActorLocation(), AdjacentTiles);
-	
-	GetWorld()->DestroyActor(TileToErase);
+	FGridMapRebuild Rebuild;
+	Rebuild.GatherCells(World, GetCellIndex(World), Cells, &MeshStreamer, bResolveUnchanged);
+	Rebuild.Compute(GetMapSeed());
+	Rebuild.Apply(UISettings.GetDebugDrawTiles(), &MeshStreamer);
+	FGridMapRebuild::ReportUnresolved(Rebuild.GetNumUnresolved());
+}
 
-	if (hasAdjacentTiles)
+void FGridMapEditorMode::SetCellTileSet(const FIntVector& Cell, UGridMapTileSet* TileSet)
+{
+	// the data changes first, the tile actor follows it
+	if (UGridMapData* GridMapData = CellIndex.GetData())
 	{
-		UpdateAdjacentTiles(GetWorld(), AdjacentTiles);
+		GridMapData->SetTileSet(Cell, TileSet);
 	}
+	SyncCellTile(Cell);
+}
+
+void FGridMapEditorMode::SyncCellTile(const FIntVector& Cell)
+{
+	UGridMapTileSet* TileSet = CellIndex.GetTileSet(Cell);
+
+	// instanced cells stay instanced, the mesh comes from resolving the cell
+	if (AGridMapChunkActor* Chunk = CellIndex.FindChunk(Cell))
+	{
+		if (TileSet == nullptr)
+		{
+			Chunk->RemoveTile(Cell);
+		}
+		else if (Chunk->FindTile(Cell)->TileSet != TileSet)
+		{
+			Chunk->SetTile(Cell, TileSet, Chunk->GetTileMesh(Cell), Chunk->GetTileRotation(Cell));
+		}
+		return;
+	}
+
+	AGridMapStaticMeshActor* Tile = CellIndex.Find(Cell);
+	if (Tile && TileSet == nullptr)
+	{
+		ReleaseTile(Tile);
+	}
+	else if (Tile && Tile->TileSet != TileSet)
+	{
+		ReplaceTile(Tile, TileSet, TSoftObjectPtr<UStaticMesh>(), Tile->GetActorRotation());
+	}
+	else if (Tile == nullptr && TileSet)
+	{
+		// the mesh comes from resolving the cell
+		SpawnTile(TileSet, TSoftObjectPtr<UStaticMesh>(), CellIndex.CellToLocation(Cell), FRotator::ZeroRotator);
+	}
+}
+
+AGridMapStaticMeshActor* FGridMapEditorMode::SpawnTile(UGridMapTileSet* TileSet, const TSoftObjectPtr<UStaticMesh>& StaticMesh, const FVector& Location, const FRotator& Rotation)
+{
+	// recycle an erased tile if there's one around
+	AGridMapStaticMeshActor* MeshActor = TilePool.Acquire(GetWorld(), UISettings.GetHideOwnedActors());
+	if (MeshActor)
+	{
+		// the tile set always changes for a pooled tile, which puts it back in the index
+		MeshActor->SetActorLocation(Location);
+		ReplaceTile(MeshActor, TileSet, StaticMesh, Rotation);
+		return MeshActor;
+	}
+
+	// the level's actor list is part of the edit, so undoing some other transaction can't lose the tile
+	GetWorld()->PersistentLevel->Modify();
+
+	FActorSpawnParameters SpawnParameters;
+	if (UISettings.GetHideOwnedActors())
+	{
+		SpawnParameters.bHideFromSceneOutliner = true;
+	}
+	MeshActor = GetWorld()->SpawnActor<AGridMapStaticMeshActor>(Location, Rotation, SpawnParameters);
+	MeshActor->TileSet = TileSet;
+
+	// Rename the display name of the new actor in the editor to reflect the mesh that is being created from.
+	LabelTile(MeshActor, TileSet, Location);
+
+	MeshStreamer.SetTileMesh(MeshActor, StaticMesh);
+	MeshActor->ReregisterAllComponents();
+
+	FTransform TileTransform = FTransform(Rotation.Quaternion(), Location, FVector::OneVector);
+	MeshActor->SetActorTransform(TileTransform);
+	CellIndex.Add(MeshActor);
+
+	return MeshActor;
+}
+
+void FGridMapEditorMode::ReplaceTile(AGridMapStaticMeshActor* Tile, UGridMapTileSet* TileSet, const TSoftObjectPtr<UStaticMesh>& StaticMesh, const FRotator& Rotation)
+{
+	// not recorded, undo syncs the tile from the grid data again
+	if (Tile->TileSet != TileSet)
+	{
+		Tile->TileSet = TileSet;
+		LabelTile(Tile, TileSet, Tile->GetActorLocation());
+		CellIndex.Add(Tile);
+	}
+
+	MeshStreamer.SetTileMesh(Tile, StaticMesh);
+	Tile->SetActorRotation(Rotation);
+}
+
+void FGridMapEditorMode::ReleaseTile(AGridMapStaticMeshActor* Tile)
+{
+	CellIndex.Remove(Tile);
+
+	// drops any load that's still pending for it
+	MeshStreamer.SetTileMesh(Tile, TSoftObjectPtr<UStaticMesh>());
+	TilePool.Release(Tile);
 }
 
 bool FGridMapEditorMode::InputKey(FEditorViewportClient* InViewportClient, FViewport* InViewport, FKey InKey, EInputEvent InEvent)
@@ -350,7 +796,12 @@ bool FGridMapEditorMode::InputKey(FEditorViewportClient* InViewportClient, FView
 		if (bUserWantsPaint)
 		{
 			bHandled = true;
-			PaintTile();
+			UpdateStroke();
+		}
+		else if (InKey == EKeys::LeftMouseButton && InEvent == IE_Released)
+		{
+			// in case tracking never started (ie. a single click)
+			CommitStroke();
 		}
 	}
 
@@ -369,12 +820,15 @@ bool FGridMapEditorMode::HandleClick(FEditorViewportClient* InViewportClient, HH
 
 void FGridMapEditorMode::GridMapBrushTrace(FEditorViewportClient* ViewportClient, const FVector& InRayOrigin, const FVector& InRayDirection)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_BrushTrace);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_BrushTrace);
+
 	bBrushTraceValid = false;
 	BrushTraceHitActor.Reset();
 
 	if (ViewportClient == nullptr || (!ViewportClient->IsMovingCamera() && ViewportClient->IsVisible()))
 	{
-		if (UISettings.GetPaintToolSelected())
+		if (UISettings.GetAnyPaintToolSelected())
 		{
 			const FPlane GroundPlane(UISettings.GetPaintOrigin(), FVector::UpVector);
 
@@ -382,12 +836,143 @@ void FGridMapEditorMode::GridMapBrushTrace(FEditorViewportClient* ViewportClient
 			BrushLocation = SnapLocation(IntersectionLocation);
 			bBrushTraceValid = true;
 
+			// still over the same cell and nothing's changed since, the last hit still stands
+			const FGridMapCellIndex& Index = GetCellIndex(GetWorld());
+			const FIntVector Cell = Index.LocationToCell(BrushLocation);
+			if (BrushTraceCell.IsSet() && BrushTraceCell.GetValue() == Cell && BrushTraceRevision == Index.GetRevision())
+			{
+				BrushTraceHitActor = BrushTraceCachedHitActor;
+				return;
+			}
+
 			TArray<AGridMapStaticMeshActor*> HitTiles;
 			TilesAt(GetWorld(), BrushLocation, HitTiles);
 			if (HitTiles.Num() > 0)
 			{
 				BrushTraceHitActor = HitTiles[0];
 			}
+
+			BrushTraceCell = Cell;
+			BrushTraceRevision = Index.GetRevision();
+			BrushTraceCachedHitActor = BrushTraceHitActor;
+		}
+	}
+}
+
+void FGridMapEditorMode::UpdateTilePreview(UWorld* World)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_TilePreview);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_TilePreview);
+
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+	const FIntVector Cell = Index.LocationToCell(BrushLocation);
+
+	// erasing previews the neighbours as if the cell were empty
+	UGridMapTileSet* TileSet = UISettings.GetPaintMode() == EGridMapPaintMode::Erase ? nullptr : UISettings.GetCurrentTileSet().Get();
+	if (TileSet == nullptr && UISettings.GetPaintMode() != EGridMapPaintMode::Erase)
+	{
+		HideTilePreview();
+		return;
+	}
+
+	// the ghosts are still right where they are
+	if (TilePreviewCell.IsSet() && TilePreviewCell.GetValue() == Cell && TilePreviewRevision == Index.GetRevision() && TilePreviewTileSet.Get() == TileSet)
+		return;
+
+	TilePreviewCell = Cell;
+	TilePreviewRevision = Index.GetRevision();
+	TilePreviewTileSet = TileSet;
+
+	// what the grid would look like with the brush's tile set in the cell
+	auto GetTileSetAt = [&Index, &Cell, TileSet](const FIntVector& InCell) -> const UGridMapTileSet*
+	{
+		return InCell == Cell ? TileSet : Index.GetTileSet(InCell);
+	};
+
+	const int32 Seed = GetMapSeed();
+	int32 NumPreviews = 0;
+
+	if (TileSet)
+	{
+		const FGridMapTileList* TileList = TileSet->FindTilesForAdjacency(FGridMapRebuild::GetAdjacencyBitmask(TileSet, Cell, GetTileSetAt));
+		if (TileList)
+		{
+			const FTransform Transform(TileList->Rotation, Index.CellToLocation(Cell));
+			ShowTilePreview(NumPreviews++, World, TileList->GetTileForCell(Cell, Seed).Get(), Transform);
+		}
+	}
+
+	TSet<FIntVector> Neighbours;
+	FGridMapRebuild::AddCellAndNeighbours(Cell, Neighbours);
+	Neighbours.Remove(Cell);
+
+	for (const FIntVector& NeighbourCell : Neighbours)
+	{
+		const AGridMapStaticMeshActor* Tile = Index.Find(NeighbourCell);
+		if (Tile == nullptr || Tile->TileSet == nullptr)
+			continue;
+
+		const FGridMapTileList* TileList = Tile->TileSet->FindTilesForAdjacency(FGridMapRebuild::GetAdjacencyBitmask(Tile->TileSet, NeighbourCell, GetTileSetAt));
+		if (TileList == nullptr)
+			continue;
+
+		// only the neighbours that would actually change
+		const TSoftObjectPtr<UStaticMesh> StaticMesh = TileList->GetTileForCell(NeighbourCell, Seed);
+		if (StaticMesh.ToSoftObjectPath() == MeshStreamer.GetTileMesh(Tile) && Tile->GetActorRotation().Equals(TileList->Rotation))
+			continue;
+
+		const FTransform Transform(TileList->Rotation, Tile->GetActorLocation(), Tile->GetActorScale3D());
+		ShowTilePreview(NumPreviews++, World, StaticMesh.Get(), Transform);
+	}
+
+	for (int32 PreviewIndex = NumPreviews; PreviewIndex < TilePreviewComponents.Num(); ++PreviewIndex)
+	{
+		if (TilePreviewComponents[PreviewIndex]->IsRegistered())
+		{
+			TilePreviewComponents[PreviewIndex]->UnregisterComponent();
+		}
+	}
+}
+
+void FGridMapEditorMode::ShowTilePreview(int32 PreviewIndex, UWorld* World, UStaticMesh* StaticMesh, const FTransform& Transform)
+{
+	if (!TilePreviewComponents.IsValidIndex(PreviewIndex))
+	{
+		UStaticMeshComponent* PreviewComponent = NewObject<UStaticMeshComponent>(GetTransientPackage());
+		PreviewComponent->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+		PreviewComponent->SetAbsolute(true, true, true);
+		PreviewComponent->CastShadow = false;
+		TilePreviewComponents.Add(PreviewComponent);
+	}
+
+	// meshes that haven't streamed in yet show as the brush cube, same as the tiles do
+	UStaticMesh* PreviewMesh = StaticMesh ? StaticMesh : TileBrushComponent->GetStaticMesh();
+	UStaticMeshComponent* PreviewComponent = TilePreviewComponents[PreviewIndex];
+	if (PreviewComponent->GetStaticMesh() != PreviewMesh)
+	{
+		PreviewComponent->SetStaticMesh(PreviewMesh);
+		for (int32 MaterialIndex = 0; MaterialIndex < PreviewComponent->GetNumMaterials(); ++MaterialIndex)
+		{
+			PreviewComponent->SetMaterial(MaterialIndex, BrushMID);
+		}
+	}
+	PreviewComponent->SetRelativeTransform(Transform);
+
+	if (!PreviewComponent->IsRegistered())
+	{
+		PreviewComponent->RegisterComponentWithWorld(World);
+	}
+}
+
+void FGridMapEditorMode::HideTilePreview()
+{
+	TilePreviewCell.Reset();
+
+	for (UStaticMeshComponent* PreviewComponent : TilePreviewComponents)
+	{
+		if (PreviewComponent->IsRegistered())
+		{
+			PreviewComponent->UnregisterComponent();
 		}
 	}
 }
@@ -395,16 +980,17 @@ void FGridMapEditorMode::GridMapBrushTrace(FEditorViewportClient* ViewportClient
 FVector FGridMapEditorMode::SnapLocation(const FVector& InLocation)
 {
 	int32 SnapWidth = GetTileSize();
-	if (SnapWidth <= 0) {
+	int32 SnapHeight = GetTileHeight();
+	if (SnapWidth <= 0 || SnapHeight <= 0) {
 		return InLocation;
 	}
 	float X = InLocation.X / SnapWidth;
 	float Y = InLocation.Y / SnapWidth;
-	float Z = InLocation.Z / SnapWidth;
+	float Z = InLocation.Z / SnapHeight;
 
 	X = FMath::RoundToInt(X) * SnapWidth;
 	Y = FMath::RoundToInt(Y) * SnapWidth;
-	Z = FMath::RoundToInt(Z) * SnapWidth;
+	Z = FMath::RoundToInt(Z) * SnapHeight;
 	return FVector(X, Y, Z);
 }
 
@@ -419,6 +1005,126 @@ bool FGridMapEditorMode::Select(AActor* InActor, bool bInSelected)
 	return true;
 }
 
+bool FGridMapEditorMode::MatchesContext(const FTransactionContext& InContext, const TArray<TPair<UObject*, FTransactionObjectEvent>>& TransactionObjectContexts) const
+{
+	// the seed is the only thing kept on the info itself and has its own rebuild, anything else could've added or removed tiles
+	for (const TPair<UObject*, FTransactionObjectEvent>& TransactionObjectContext : TransactionObjectContexts)
+	{
+		if (!Cast<AGridMapInfo>(TransactionObjectContext.Key))
+			return true;
+	}
+	return false;
+}
+
+void FGridMapEditorMode::PostUndo(bool bSuccess)
+{
+	// tiles spawned or destroyed by an edit come and go with the level, just start over
+	TilePool.Reconcile();
+	CellIndex.Invalidate();
+	SyncRestoredCells();
+}
+
+void FGridMapEditorMode::PostRedo(bool bSuccess)
+{
+	TilePool.Reconcile();
+	CellIndex.Invalidate();
+	SyncRestoredCells();
+}
+
+void FGridMapEditorMode::OnPreSaveWorld(UWorld* World, FObjectPreSaveContext ObjectSaveContext)
+{
+	// tiles still waiting on their mesh would be saved with the placeholder
+	MeshStreamer.FlushRequestsSynchronous();
+}
+
+void FGridMapEditorMode::OnCellsRestored(UGridMapData* GridMapData, const TArray<FIntVector>& Cells)
+{
+	TSet<FIntVector>& DataCells = RestoredCells.FindOrAdd(GridMapData);
+	DataCells.Append(Cells);
+}
+
+void FGridMapEditorMode::SyncRestoredCells()
+{
+	UWorld* World = GetWorld();
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+
+	// only the level being edited has a view to sync, other levels' tiles are synced when they're next edited
+	TSet<FIntVector> Cells;
+	if (TSet<FIntVector>* DataCells = RestoredCells.Find(Index.GetData()))
+	{
+		Cells = MoveTemp(*DataCells);
+	}
+	RestoredCells.Reset();
+
+	// tiles undo left showing the placeholder have nothing loading for them any more, resolving them requests it again
+	for (const TPair<TWeakObjectPtr<AGridMapStaticMeshActor>, FIntVector>& Tile : Index.GetTiles())
+	{
+		if (MeshStreamer.IsShowingPlaceholder(Tile.Key.Get()))
+		{
+			Cells.Add(Tile.Value);
+		}
+	}
+
+	if (Cells.Num() == 0)
+		return;
+
+	for (const FIntVector& Cell : Cells)
+	{
+		SyncCellTile(Cell);
+	}
+	// the tiles were only just synced, they don't necessarily show what the data says they resolved to
+	ResolveCells(World, Cells, true);
+
+	TilePreviewCell.Reset();
+}
+
+void FGridMapEditorMode::OnLevelActorAdded(AActor* InActor)
+{
+	if (AGridMapStaticMeshActor* Tile = Cast<AGridMapStaticMeshActor>(InActor))
+	{
+		GetCellIndex(GetWorld());
+		FGridMapViewSync::RecordTileMoved(CellIndex, Tile);
+	}
+}
+
+void FGridMapEditorMode::OnLevelActorDeleted(AActor* InActor)
+{
+	if (AGridMapStaticMeshActor* Tile = Cast<AGridMapStaticMeshActor>(InActor))
+	{
+		GetCellIndex(GetWorld());
+		FGridMapViewSync::RecordTileDeleted(CellIndex, Tile);
+	}
+}
+
+void FGridMapEditorMode::OnActorMoved(AActor* InActor)
+{
+	if (AGridMapStaticMeshActor* Tile = Cast<AGridMapStaticMeshActor>(InActor))
+	{
+		GetCellIndex(GetWorld());
+		FGridMapViewSync::RecordTileMoved(CellIndex, Tile);
+	}
+}
+
+void FGridMapEditorMode::OnMapChanged(uint32 MapChangeFlags)
+{
+	TimeSlicedRebuild.Cancel();
+	CellIndex.Invalidate();
+}
+
+void FGridMapEditorMode::OnLevelAddedOrRemoved(ULevel* InLevel, UWorld* InWorld)
+{
+	CellIndex.Invalidate();
+}
+
+void FGridMapEditorMode::OnMapSeedChanged(AGridMapInfo* GridMapInfo)
+{
+	// every tile might pick a different variant now
+	if (GridMapInfo && GridMapInfo->GetWorld() == GetWorld())
+	{
+		RequestUpdateAllTiles();
+	}
+}
+
 bool FGridMapEditorMode::IsSelectionAllowed(AActor* InActor, bool bInSelection) const
 {
 	return false;
@@ -428,6 +1134,9 @@ void FGridMapEditorMode::ClearAllToolSelection()
 {
 	UISettings.SetPaintToolSelected(false);
 	UISettings.SetSelectToolSelected(false);
+	UISettings.SetRectangleToolSelected(false);
+	UISettings.SetLineToolSelected(false);
+	UISettings.SetFillToolSelected(false);
 	UISettings.SetSettingsToolSelected(false);
 }
 
@@ -444,12 +1153,38 @@ void FGridMapEditorMode::OnSetSelectTiles()
 	UISettings.SetSelectToolSelected(true);
 }
 
+void FGridMapEditorMode::OnSetRectangleTiles()
+{
+	ClearAllToolSelection();
+	UISettings.SetRectangleToolSelected(true);
+}
+
+void FGridMapEditorMode::OnSetLineTiles()
+{
+	ClearAllToolSelection();
+	UISettings.SetLineToolSelected(true);
+}
+
+void FGridMapEditorMode::OnSetFillTiles()
+{
+	ClearAllToolSelection();
+	UISettings.SetFillToolSelected(true);
+}
+
 void FGridMapEditorMode::OnSetTileSettings()
 {
 	ClearAllToolSelection();
 	UISettings.SetSettingsToolSelected(true);
 }
 
+UWorld* FGridMapEditorMode::GetWorld() const
+{
+	if (UWorld* World = WorldOverride.Get())
+		return World;
+
+	return FEdMode::GetWorld();
+}
+
 EGridMapEditingState FGridMapEditorMode::GetEditingState() const
 {
 	UWorld* World = GetWorld();
@@ -472,173 +1207,208 @@ EGridMapEditingState FGridMapEditorMode::GetEditingState() const
 
 uint32 FGridMapEditorMode::GetTileAdjacencyBitmask(UWorld* World, const FVector& Origin, UGridMapTileSet* TileSet) const
 {
-	uint32 bitmask = 0;
-
-	TArray<FAdjacentTile> AdjacentTiles;
-	if (GetAdjacentTiles(World, Origin, AdjacentTiles, TileSet->bMatchesEmpty))
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+	return FGridMapRebuild::GetAdjacencyBitmask(TileSet, Index.LocationToCell(Origin), [&Index](const FIntVector& Cell) -> const UGridMapTileSet*
 	{
-		for (const FAdjacentTile& AdjacentTile : AdjacentTiles)
-		{
-			if (AdjacentTile.Key && TileSet->AdjacencyTagRequirements.RequirementsMet(AdjacentTile.Key->TileSet->TileTags))
-				bitmask |= AdjacentTile.Value;
-			else if (AdjacentTile.Key == nullptr)
-			{
-				bitmask |= AdjacentTile.Value;
-			}
-		}
-	}
-
-	return bitmask;
+		return Index.GetTileSet(Cell);
+	});
 }
 
 bool FGridMapEditorMode::TilesAt(UWorld* World, const FVector& Origin, TArray<AGridMapStaticMeshActor*>& OutTiles) const
 {
-	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
-	TArray<AActor*> ActorsToIgnore;
-	TArray<AActor*> OutActors;
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_TilesAt);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_TilesAt);
 
-	int scaledGridSize = (int)((GetTileSize() * .95f)/2.f);
-	int scaledGridHeight = (int)(GetTileHeight()/2.f);
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+	if (AGridMapStaticMeshActor* Tile = Index.Find(Index.LocationToCell(Origin)))
+	{
+		OutTiles.Add(Tile);
+	}
 
-	float tileCheckRadius = scaledGridSize * .45f;
+	return OutTiles.Num() > 0;
+}
 
-	//if (UKismetSystemLibrary::SphereOverlapActors(World, Origin, tileCheckRadius, ObjectTypes, AGridMapStaticMeshActor::StaticClass(), ActorsToIgnore, OutActors))
-	if (UKismetSystemLibrary::BoxOverlapActors(World, Origin, FVector(scaledGridSize, scaledGridSize, scaledGridHeight), ObjectTypes, AGridMapStaticMeshActor::StaticClass(), ActorsToIgnore, OutActors))
+const FGridMapCellIndex& FGridMapEditorMode::GetCellIndex(UWorld* World) const
+{
+	if (!CellIndex.IsValidFor(World, GetTileSize(), GetTileHeight()))
 	{
-		OutTiles.Reserve(OutActors.Num());
-		for (AActor* OutActor : OutActors)
-		{
-			if (Cast<AGridMapStaticMeshActor>(OutActor))
-				OutTiles.Add(Cast<AGridMapStaticMeshActor>(OutActor));
-		}
+		CellIndex.Rebuild(World, GetTileSize(), GetTileHeight(), &TilePool);
 	}
 
-	return OutTiles.Num() > 0;
+	return CellIndex;
 }
 
 void FGridMapEditorMode::UpdateAllTiles()
 {
-	TArray<FAdjacentTile> AllTiles;
-	
-	for (TActorIterator<AGridMapStaticMeshActor> It(GetWorld(), AGridMapStaticMeshActor::StaticClass()); It; ++It)
+	UWorld* World = GetWorld();
+
+	// everything is about to be rebuilt anyway
+	TimeSlicedRebuild.Cancel();
+
+	FGridMapRebuild Rebuild;
+	Rebuild.Gather(World, GetCellIndex(World), &MeshStreamer);
+	Rebuild.Compute(GetMapSeed());
+	Rebuild.Apply(UISettings.GetDebugDrawTiles(), &MeshStreamer);
+	FGridMapRebuild::ReportUnresolved(Rebuild.GetNumUnresolved());
+
+	// meshes changed without the index noticing, the ghosts could be out of date
+	TilePreviewCell.Reset();
+}
+
+bool FGridMapEditorMode::TickTimeSlicedRebuild(float DeltaTime)
+{
+	// wait for the edit to be over, its cell states and transaction are still open
+	if (EditTransaction.IsValid() || bIsPainting)
+		return true;
+
+	if (TimeSlicedRebuild.IsRunning())
 	{
-		AGridMapStaticMeshActor* Actor = *It;
-		if (IsValid(Actor))
+		UWorld* World = GetWorld();
+		if (TimeSlicedRebuild.Tick(GetCellIndex(World), UISettings.GetRebuildBudgetMs(), UISettings.GetDebugDrawTiles(), &MeshStreamer))
 		{
-			AllTiles.Add(FAdjacentTile(Actor, 0));
+			TilePreviewCell.Reset();
 		}
 	}
 
-	UpdateAdjacentTiles(GetWorld(), AllTiles);
+	return true;
 }
 
-void FGridMapEditorMode::UpdateAdjacentTiles(UWorld* World, const TArray<FAdjacentTile>& RootActors)
+void FGridMapEditorMode::RequestUpdateAllTiles()
 {
-	TArray<FAdjacentTile> AdjacentTiles;
-	TArray<AGridMapStaticMeshActor*> ProcessedActors;
-	TQueue<AGridMapStaticMeshActor*> QueuedActors;
+	UWorld* World = GetWorld();
+	const FGridMapCellIndex& Index = GetCellIndex(World);
 
-	for (const FAdjacentTile& RootTile : RootActors)
+	// without grid data there are no chunks to slice the work up by
+	if (!UISettings.GetTimeSliceRebuilds() || Index.GetData() == nullptr)
 	{
-		QueuedActors.Enqueue(RootTile.Key);
+		UpdateAllTiles();
+		return;
 	}
-	
-	while (!QueuedActors.IsEmpty())
-	{
-		AGridMapStaticMeshActor* CurrentActor = nullptr;
-		QueuedActors.Dequeue(CurrentActor);
 
-		// have we already been processed?
-		if (ProcessedActors.Contains(CurrentActor))
-			continue;
+	TimeSlicedRebuild.Start(World, Index, GetMapSeed());
+}
 
-		UGridMapTileSet* TileSet = CurrentActor->TileSet;
-		uint32 Adjacency = GetTileAdjacencyBitmask(GetWorld(), CurrentActor->GetActorLocation(), TileSet);
-		const FGridMapTileList* TileList = TileSet->FindTilesForAdjacency(Adjacency);
-		if (TileList == nullptr)
+void FGridMapEditorMode::ConvertTilesToInstances()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+		return;
+
+	// chunks take whatever mesh the tile is showing, so it can't be a placeholder
+	MeshStreamer.FlushRequestsSynchronous();
+
+	const FGridMapCellIndex& Index = GetCellIndex(World);
+
+	const FScopedTransaction Transaction(LOCTEXT("ConvertTilesToInstancesTransaction", "Convert Tiles To Instances"), bTransactEdits);
+	World->PersistentLevel->Modify();
+
+	// instanced cells only exist in the grid data
+	CellIndex.FindOrCreateInfo();
+
+	TArray<AGridMapStaticMeshActor*> TilesToConvert;
+	for (const TPair<TWeakObjectPtr<AGridMapStaticMeshActor>, FIntVector>& Tile : Index.GetTiles())
+	{
+		if (IsValid(Tile.Key.Get()))
 		{
-			GEngine->AddOnScreenDebugMessage(INDEX_NONE, 4.0f, FColor::Red, TEXT("Failed to find tile!"), true, FVector2D::UnitVector);
-			::DrawDebugPoint(GetWorld(), CurrentActor->GetActorLocation(), 12, FColor::Red, false, 10.f);
-			continue;
+			TilesToConvert.Add(Tile.Key.Get());
 		}
-		UStaticMesh* ExpectedStaticMesh = TileList->GetRandomTile().LoadSynchronous();
-		UStaticMesh* CurrentStaticMesh = CurrentActor->GetStaticMeshComponent()->GetStaticMesh();
-
-		// it hasn't changed
-		if (CurrentStaticMesh == ExpectedStaticMesh)
-			continue;
+	}
 
-		if (UISettings.GetDebugDrawTiles())
+	int32 NumSkipped = 0;
+	for (AGridMapStaticMeshActor* Tile : TilesToConvert)
+	{
+		// an instance needs a mesh, leave the tile as it is rather than losing it
+		UStaticMesh* StaticMesh = Tile->GetStaticMeshComponent()->GetStaticMesh();
+		if (StaticMesh == nullptr)
 		{
-			DrawDebugPoint(GetWorld(), CurrentActor->GetActorLocation(), 10.f, FColor::Yellow, false, 5.0f, 255);
+			++NumSkipped;
+			continue;
 		}
 
-		// it has changed, so let's update it
-		CurrentActor->GetStaticMeshComponent()->SetStaticMesh(ExpectedStaticMesh);
-		CurrentActor->SetActorRotation(TileList->Rotation);
-		ProcessedActors.Add(CurrentActor);
+		const FIntVector Cell = Index.LocationToCell(Tile->GetActorLocation());
+		const FIntVector ChunkCoord = UGridMapData::CellToChunk(Cell);
 
-		// find any neighbors that haven't been updated, and queue them for an update
-		if (GetAdjacentTiles(World, CurrentActor->GetActorLocation(), AdjacentTiles))
+		AGridMapChunkActor* Chunk = CellIndex.GetChunk(ChunkCoord);
+		if (Chunk == nullptr)
 		{
-			for (const FAdjacentTile& AdjacentTile : AdjacentTiles)
-			{
-				if (AdjacentTile.Key && !ProcessedActors.Contains(AdjacentTile.Key))
-				{
-					QueuedActors.Enqueue(AdjacentTile.Key);
-				}
-			}
+			Chunk = World->SpawnActor<AGridMapChunkActor>();
+			Chunk->InitChunk(ChunkCoord, Index.GetCellSize(), Index.GetCellHeight());
+			FActorLabelUtilities::SetActorLabelUnique(Chunk, FString::Printf(TEXT("GridMapChunk_%d_%d_%d"), ChunkCoord.X, ChunkCoord.Y, ChunkCoord.Z));
+			CellIndex.AddChunk(Chunk);
 		}
-	}
-}
 
-bool FGridMapEditorMode::GetAdjacentTiles(UWorld* World, const FVector& Origin, TArray<TPair<AGridMapStaticMeshActor*, uint32>>& OutAdjacentTiles, bool bIncludeEmptyTiles) const
-{
-	static const int TileCount = 8;
+		Chunk->SetTile(Cell, Tile->TileSet, StaticMesh, Tile->GetActorRotation());
 
-	static FVector Offsets[TileCount]{
-		FVector(0, -GetTileSize(), 0),	// top-center
-		FVector(-GetTileSize(), 0, 0),	// center-left
-		FVector(GetTileSize(), 0, 0),	// center-right
-		FVector(0, GetTileSize(), 0),	// botton-center
+		CellIndex.Remove(Tile);
+		World->DestroyActor(Tile);
+	}
 
-		FVector(-GetTileSize(), -GetTileSize(), 0),	// top left
-		FVector(GetTileSize(), -GetTileSize(), 0),	// top right
-		FVector(-GetTileSize(), GetTileSize(), 0),	// bottom left
-		FVector(GetTileSize(), GetTileSize(), 0),	// bottom right
-	};
+	if (NumSkipped > 0)
+	{
+		UE_LOG(LogGridMapEditor, Warning, TEXT("%d tiles have no mesh and were left as actors"), NumSkipped);
+	}
+}
 
-	static uint32 Bits[TileCount]{
-		1 << 0, // top
-		1 << 1, // left
-		1 << 2, // right
-		1 << 3, // bottom
+void FGridMapEditorMode::ConvertInstancesToTiles()
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+		return;
 
-		1 << 4,	// top left
-		1 << 5,	// top right
-		1 << 6,	// bottom left
-		1 << 7,	// bottom right
-	};
+	const FScopedTransaction Transaction(LOCTEXT("ConvertInstancesToTilesTransaction", "Convert Instances To Tiles"), bTransactEdits);
+	World->PersistentLevel->Modify();
 
-	TArray<AGridMapStaticMeshActor*> Tiles;
-	for (int i = 0; i < TileCount; ++i)
+	TArray<AGridMapChunkActor*> ChunksToConvert;
+	for (TActorIterator<AGridMapChunkActor> It(World); It; ++It)
 	{
-		if (TilesAt(World, Origin + Offsets[i], Tiles))
+		if (IsValid(*It))
 		{
-			for (AGridMapStaticMeshActor* Tile : Tiles)
-			{
-				OutAdjacentTiles.Add(TPair<AGridMapStaticMeshActor*, uint32>(Tile, Bits[i]));
-			}
-			Tiles.Empty();
+			ChunksToConvert.Add(*It);
 		}
-		else if (bIncludeEmptyTiles)
+	}
+
+	for (AGridMapChunkActor* Chunk : ChunksToConvert)
+	{
+		const float ChunkCellSize = Chunk->GetCellSize();
+		const float ChunkCellHeight = Chunk->GetCellHeight();
+		for (const TPair<FIntVector, FGridMapChunkTile>& Tile : Chunk->GetTiles())
 		{
-			OutAdjacentTiles.Add(TPair<AGridMapStaticMeshActor*, uint32>(nullptr, Bits[i]));
+			const FIntVector& Cell = Tile.Key;
+			const FVector Location(Cell.X * ChunkCellSize, Cell.Y * ChunkCellSize, Cell.Z * ChunkCellHeight);
+			SpawnTile(Tile.Value.TileSet, TSoftObjectPtr<UStaticMesh>(Chunk->GetTileMesh(Cell)), Location, Chunk->GetTileRotation(Cell));
 		}
 
+		World->DestroyActor(Chunk);
 	}
+}
 
-	return OutAdjacentTiles.Num() > 0;
+int32 FGridMapEditorMode::GetMapSeed() const
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr)
+		return 0;
+
+	const AGridMapInfo* GridMapInfo = GetCellIndex(World).GetInfo();
+	return GridMapInfo ? GridMapInfo->Seed : 0;
+}
+
+void FGridMapEditorMode::SetMapSeed(int32 NewSeed)
+{
+	UWorld* World = GetWorld();
+	if (World == nullptr || GetMapSeed() == NewSeed)
+		return;
+
+	const FScopedTransaction Transaction(LOCTEXT("SetMapSeedTransaction", "Set Grid Map Seed"), bTransactEdits);
+
+	AGridMapInfo* GridMapInfo = CellIndex.FindOrCreateInfo();
+	if (GridMapInfo == nullptr)
+		return;
+
+	GridMapInfo->Modify();
+	GridMapInfo->Seed = NewSeed;
+
+	// every tile might pick a different variant now
+	RequestUpdateAllTiles();
 }
 
 int32 FGridMapEditorMode::GetTileSize() const
@@ -668,6 +1438,20 @@ void FGridMapEditorMode::AddActiveTileSet(UGridMapTileSet* TileSet)
 	}
 
 	ActiveTileSets.Add(TileSet);
+
+	// warm up the meshes so the first strokes don't have to wait on them
+	MeshStreamer.PreloadTileSet(TileSet);
+}
+
+void FGridMapEditorMode::RemoveActiveTileSet(UGridMapTileSet* TileSet)
+{
+	if (ActiveTileSets.Remove(TileSet) == 0)
+		return;
+
+	if (ActiveTileSet != TileSet)
+	{
+		MeshStreamer.ReleaseTileSet(TileSet);
+	}
 }
 
 const TArray<UGridMapTileSet*>& FGridMapEditorMode::GetActiveTileSets() const
@@ -677,6 +1461,8 @@ const TArray<UGridMapTileSet*>& FGridMapEditorMode::GetActiveTileSets() const
 
 void FGridMapEditorMode::SetActiveTileSet(UGridMapTileSet* TileSet)
 {
+	UGridMapTileSet* PreviousTileSet = ActiveTileSet;
+
 	ActiveTileSet = TileSet;
 	for (UGridMapTileSet* ExistingTileSet : ActiveTileSets)
 	{
@@ -687,6 +1473,23 @@ void FGridMapEditorMode::SetActiveTileSet(UGridMapTileSet* TileSet)
 	}
 
 	UISettings.SetCurrentTileSet(ActiveTileSet);
+
+	// tile sets in the palette keep their meshes loaded, anything else only while it's selected
+	if (PreviousTileSet && PreviousTileSet != ActiveTileSet && !ActiveTileSets.Contains(PreviousTileSet))
+	{
+		MeshStreamer.ReleaseTileSet(PreviousTileSet);
+	}
+	MeshStreamer.PreloadTileSet(ActiveTileSet);
+}
+
+float FGridMapEditorMode::GetTileSetLoadProgress(const UGridMapTileSet* TileSet) const
+{
+	return MeshStreamer.GetTileSetLoadProgress(TileSet);
+}
+
+bool FGridMapEditorMode::IsTileSetLoading(const UGridMapTileSet* TileSet) const
+{
+	return MeshStreamer.IsTileSetLoading(TileSet);
 }
 
 FString FGridMapEditorMode::CreateActorLabel(const class UGridMapTileSet* TileSet) const
@@ -695,3 +1498,31 @@ FString FGridMapEditorMode::CreateActorLabel(const class UGridMapTileSet* TileSe
 	FString CleanTileSetName = TileSetName.StartsWith("TS_") ? TileSetName.RightChop(3) : TileSetName;
 	return FString::Printf(TEXT("SM_%s"), *CleanTileSetName);
 }
+
+void FGridMapEditorMode::LabelTile(AGridMapStaticMeshActor* Tile, const UGridMapTileSet* TileSet, const FVector& Location)
+{
+	// nobody can see the label if it's not in the outliner, so don't bother
+	if (!Tile->IsListedInSceneOutliner())
+		return;
+
+	switch (UISettings.GetTileLabelMode())
+	{
+	case EGridMapTileLabelMode::Cell:
+	{
+		const FIntVector Cell = GetCellIndex(GetWorld()).LocationToCell(Location);
+		Tile->SetActorLabel(FString::Printf(TEXT("%s_%d_%d_%d"), *CreateActorLabel(TileSet), Cell.X, Cell.Y, Cell.Z));
+		break;
+	}
+	case EGridMapTileLabelMode::Counter:
+	{
+		int32& Counter = TileLabelCounters.FindOrAdd(TileSet);
+		Tile->SetActorLabel(FString::Printf(TEXT("%s_%d"), *CreateActorLabel(TileSet), ++Counter));
+		break;
+	}
+	case EGridMapTileLabelMode::Unique:
+		FActorLabelUtilities::SetActorLabelUnique(Tile, CreateActorLabel(TileSet));
+		break;
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
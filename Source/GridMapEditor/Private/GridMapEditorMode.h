@@ -3,14 +3,21 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "EdMode.h"
+#include "EditorUndoClient.h"
+#include "GridMapCellChange.h"
+#include "GridMapCellIndex.h"
 #include "GridMapEditorTypes.h"
 #include "GridMapEditorUISettings.h"
+#include "GridMapMeshStreamer.h"
+#include "GridMapTilePool.h"
+#include "GridMapTimeSlicedRebuild.h"
+#include "UObject/ObjectSaveContext.h"
 
-class FGridMapEditorMode : public FEdMode
+class FGridMapEditorMode : public FEdMode, public FEditorUndoClient
 {
-protected:
-	typedef TPair<class AGridMapStaticMeshActor*, uint32> FAdjacentTile;
+	friend class FGridMapBenchmark;
 
 public:
 	const static FEditorModeID EM_GridMapEditorModeId;
@@ -39,6 +46,15 @@ public:
 	virtual bool IsSelectionAllowed(AActor* InActor, bool bInSelection) const override;
 	// End of FEdMode interface
 
+	// FEditorUndoClient interface
+	virtual bool MatchesContext(const FTransactionContext& InContext, const TArray<TPair<UObject*, FTransactionObjectEvent>>& TransactionObjectContexts) const override;
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override;
+	// End of FEditorUndoClient interface
+
+	/** Hides FEdMode's, so the mode can also be run against a world it isn't active in */
+	class UWorld* GetWorld() const;
+
 	/** Return the current grid map editing state */
 	EGridMapEditingState GetEditingState() const;
 
@@ -49,34 +65,113 @@ public:
 	}
 
 	void AddActiveTileSet(class UGridMapTileSet* TileSet);
+	void RemoveActiveTileSet(class UGridMapTileSet* TileSet);
 	const TArray<class UGridMapTileSet*>& GetActiveTileSets() const;
 	void SetActiveTileSet(class UGridMapTileSet* TileSet);
 
+	/** Progress of the background load of the tile set's meshes */
+	float GetTileSetLoadProgress(const class UGridMapTileSet* TileSet) const;
+	bool IsTileSetLoading(const class UGridMapTileSet* TileSet) const;
+
 	void UpdateAllTiles();
+	/** Updates every tile, spread over several frames if time sliced rebuilds are turned on */
+	void RequestUpdateAllTiles();
+	bool IsUpdatingAllTiles() const { return TimeSlicedRebuild.IsRunning(); }
+	float GetUpdateAllTilesProgress() const { return TimeSlicedRebuild.GetProgress(); }
+	void CancelUpdateAllTiles() { TimeSlicedRebuild.Cancel(); }
+
+	/** Moves every tile actor into instanced chunk actors */
+	void ConvertTilesToInstances();
+	/** Turns every instanced chunk back into individual tile actors */
+	void ConvertInstancesToTiles();
+
+	/** Seed used to pick tile variants for the current map */
+	int32 GetMapSeed() const;
+	void SetMapSeed(int32 NewSeed);
 
 private:
 	void BindCommandList();
 	void ClearAllToolSelection();
 	void OnSetPaintTiles();
 	void OnSetSelectTiles();
+	void OnSetRectangleTiles();
+	void OnSetLineTiles();
+	void OnSetFillTiles();
 	void OnSetTileSettings();
 
 	void GridMapBrushTrace(FEditorViewportClient* ViewportClient, const FVector& InRayOrigin, const FVector& InRayDirection);
+
+	/** Ghosts of the tile the brush would place and the neighbours that would change because of it */
+	void UpdateTilePreview(class UWorld* World);
+	void ShowTilePreview(int32 PreviewIndex, class UWorld* World, class UStaticMesh* StaticMesh, const FTransform& Transform);
+	void HideTilePreview();
 	
 	int32 GetTileSize() const;
 	int32 GetTileHeight() const;
 
 	FVector SnapLocation(const FVector& InLocation);
 
+	/** Returns the cell index for the world, rebuilding it if it's gone stale */
+	const FGridMapCellIndex& GetCellIndex(class UWorld* World) const;
+
+	void OnLevelActorAdded(AActor* InActor);
+	void OnLevelActorDeleted(AActor* InActor);
+	void OnActorMoved(AActor* InActor);
+	void OnMapChanged(uint32 MapChangeFlags);
+	void OnLevelAddedOrRemoved(class ULevel* InLevel, class UWorld* InWorld);
+	void OnMapSeedChanged(class AGridMapInfo* GridMapInfo);
+	void OnCellsRestored(class UGridMapData* GridMapData, const TArray<FIntVector>& Cells);
+	void OnPreSaveWorld(class UWorld* World, FObjectPreSaveContext ObjectSaveContext);
+
+	/** Brings the restored cells' tiles in line with the grid data and resolves them */
+	void SyncRestoredCells();
+
+	/** Core ticker callback while the mode is active, advances a time sliced rebuild */
+	bool TickTimeSlicedRebuild(float DeltaTime);
+
 	void PaintTile();
-	void EraseTile(class AGridMapStaticMeshActor* TileToErase);
+
+	/** Stroke batching, cells are recorded while dragging and committed all at once */
+	void UpdateStroke();
+	void RecordStrokeCell();
+	/** Rectangle and line tools, the stroke is the shape between the anchor and the brush */
+	void RecordShapeStroke();
+	/** Fill tool, the stroke is the connected area under the brush */
+	void RecordFillStroke();
+	void RecordStrokeCellAt(const FIntVector& Cell);
+	void ClearStrokeCells();
+	void CommitStroke();
+	bool HasPendingStroke() const { return StrokeCells.Num() > 0; }
+
+	/**
+	 * Undo, an edit opens a transaction that any new tiles are spawned in. The cells' grid data
+	 * is captured before the edit and only the cells that changed get stored, when the edit is
+	 * over and the transaction is closed. Tiles that are retiled or pooled aren't recorded.
+	 */
+	void CaptureCellStates(class UWorld* World, const TSet<FIntVector>& Cells);
+	void BeginEdit(class UWorld* World);
+	void StoreCellChange(class UWorld* World);
+
+	/**
+	 * Resolves the tiles in the cells in a single pass, ie. after the cells' occupancy changed.
+	 * Cells whose mask didn't change are skipped unless bResolveUnchanged is set.
+	 */
+	void ResolveCells(class UWorld* World, const TSet<FIntVector>& Cells, bool bResolveUnchanged = false);
+	/** Changes the cell in the grid data, then brings its tile actor or instance in line */
+	void SetCellTileSet(const FIntVector& Cell, class UGridMapTileSet* TileSet);
+	/** Spawns, retiles or releases the cell's tile actor to match what the grid data says is there, instanced cells are retiled or removed in their chunk instead */
+	void SyncCellTile(const FIntVector& Cell);
+	class AGridMapStaticMeshActor* SpawnTile(class UGridMapTileSet* TileSet, const TSoftObjectPtr<class UStaticMesh>& StaticMesh, const FVector& Location, const FRotator& Rotation);
+	/** Swaps the tile's set, mesh and rotation in place instead of respawning it */
+	void ReplaceTile(class AGridMapStaticMeshActor* Tile, class UGridMapTileSet* TileSet, const TSoftObjectPtr<class UStaticMesh>& StaticMesh, const FRotator& Rotation);
+	/** Takes the tile off the map and into the pool */
+	void ReleaseTile(class AGridMapStaticMeshActor* Tile);
 
 	uint32 GetTileAdjacencyBitmask(class UWorld* World, const FVector& Origin, UGridMapTileSet* TileSet) const;
 	bool TilesAt(class UWorld* World, const FVector& Origin, TArray<class AGridMapStaticMeshActor*>& OutTiles) const;
-	bool GetAdjacentTiles(class UWorld* World, const FVector& Origin, TArray<TPair<class AGridMapStaticMeshActor*, uint32>>& OutAdjacentTiles, bool bIncludeEmptyTiles = false) const;
-	void UpdateAdjacentTiles(class UWorld* World, const TArray<FAdjacentTile>& RootActors);
 
 	FString CreateActorLabel(const class UGridMapTileSet* TileSet) const;
+	void LabelTile(class AGridMapStaticMeshActor* Tile, const class UGridMapTileSet* TileSet, const FVector& Location);
 
 public:
 	FGridMapEditorUISettings UISettings;
@@ -91,6 +186,10 @@ private:
 	FVector BrushLocation;
 	FVector BrushTraceDirection;
 	TWeakObjectPtr<class AActor> BrushTraceHitActor;
+	/** Last traced cell and what was in it, reused until the brush moves to another cell or the grid changes */
+	TOptional<FIntVector> BrushTraceCell;
+	uint32 BrushTraceRevision;
+	TWeakObjectPtr<class AActor> BrushTraceCachedHitActor;
 	UStaticMeshComponent* TileBrushComponent;
 	/** The dynamic material of the tile brush. */
 	class UMaterialInstanceDynamic* BrushMID;
@@ -98,6 +197,59 @@ private:
 	FColor BrushWarningHighlightColor;
 	FColor BrushCurrentHighlightColor;
 
+	/** Cells touched by the current stroke, and what to paint there (null when erasing) */
+	TMap<FIntVector, TWeakObjectPtr<class UGridMapTileSet>> StrokeCells;
+	/** Last cell under the brush during the stroke, so fast drags can fill in the cells in between */
+	TOptional<FIntVector> LastStrokeCell;
+	/** Cell the stroke started in */
+	TOptional<FIntVector> StrokeAnchorCell;
+	/** State of the cells the current edit touched, from before it started */
+	TMap<FIntVector, FGridMapCellState> PendingCellStates;
+	/** Open from the first change of an edit until it's stored, which can span a whole drag */
+	TUniquePtr<class FScopedTransaction> EditTransaction;
+	/** False for a mode driving a scratch world, whose edits have no business in the undo buffer */
+	bool bTransactEdits;
+	/** World to edit instead of the level editor's, if set */
+	TWeakObjectPtr<class UWorld> WorldOverride;
+	/** Cheap preview of the stroke's cells until it's committed */
+	class UInstancedStaticMeshComponent* StrokePreviewComponent;
+
+	/** One ghost per cell the brush would change, only as many as were needed so far */
+	TArray<UStaticMeshComponent*> TilePreviewComponents;
+	/** What the ghosts were last worked out for, they're only recomputed when one of these changes */
+	TOptional<FIntVector> TilePreviewCell;
+	uint32 TilePreviewRevision;
+	TWeakObjectPtr<class UGridMapTileSet> TilePreviewTileSet;
+
+	/** Cell -> tile lookup, kept in sync with the level's tile actors */
+	mutable FGridMapCellIndex CellIndex;
+
+	/** Loads tile meshes in the background while painting and rebuilding */
+	FGridMapMeshStreamer MeshStreamer;
+
+	/** Build All Tiles, when it's running in the background */
+	FGridMapTimeSlicedRebuild TimeSlicedRebuild;
+
+	/** Erased tiles, waiting to be reused by the next spawn */
+	FGridMapTilePool& TilePool;
+
+	/** Cells undo or redo put back in each level's grid data, their tiles are synced once it's done */
+	TMap<TWeakObjectPtr<class UGridMapData>, TSet<FIntVector>> RestoredCells;
+
+	/** Last number handed out per tile set, when labelling tiles by counter */
+	TMap<TObjectKey<class UGridMapTileSet>, int32> TileLabelCounters;
+
+	FDelegateHandle OnLevelActorAddedHandle;
+	FDelegateHandle OnLevelActorDeletedHandle;
+	FDelegateHandle OnActorMovedHandle;
+	FDelegateHandle OnMapChangedHandle;
+	FDelegateHandle OnLevelAddedToWorldHandle;
+	FDelegateHandle OnLevelRemovedFromWorldHandle;
+	FDelegateHandle OnMapSeedChangedHandle;
+	FDelegateHandle OnCellsRestoredHandle;
+	FDelegateHandle OnPreSaveWorldHandle;
+	FTSTicker::FDelegateHandle TimeSlicedRebuildTickerHandle;
+
 	UPROPERTY()
 	TArray<class UGridMapTileSet*> ActiveTileSets;
 	
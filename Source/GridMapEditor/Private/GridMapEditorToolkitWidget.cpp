@@ -117,6 +117,9 @@ TSharedRef<SWidget> SGridMapEditorToolkitWidget::BuildToolBar()
 	Toolbar.SetStyle(&FEditorStyle::Get(), "FoliageEditToolbar");
 	{
 		Toolbar.AddToolBarButton(FGridMapEditCommands::Get().SetPaintTiles);
+		Toolbar.AddToolBarButton(FGridMapEditCommands::Get().SetRectangleTiles);
+		Toolbar.AddToolBarButton(FGridMapEditCommands::Get().SetLineTiles);
+		Toolbar.AddToolBarButton(FGridMapEditCommands::Get().SetFillTiles);
 		Toolbar.AddToolBarButton(FGridMapEditCommands::Get().SetSelectTiles);
 		Toolbar.AddToolBarButton(FGridMapEditCommands::Get().SetTileSettings);
 		
@@ -265,6 +268,23 @@ TSharedRef<SWidget> SGridMapEditorToolkitWidget::BuildPaintOptions()
 						]
 					]
 				]
+
+				+ SWrapBox::Slot()
+				[
+					SNew(SBox)
+					.MinDesiredWidth(150)
+					[
+						SNew(SCheckBox)
+						.OnCheckStateChanged(this, &SGridMapEditorToolkitWidget::OnCheckStateChanged_BatchStrokes)
+						.IsChecked(this, &SGridMapEditorToolkitWidget::GetCheckState_BatchStrokes)
+						.ToolTipText(LOCTEXT("GridMapBatchStrokes_ToolTip", "Whether to preview strokes while dragging and only place tiles once the mouse is released"))
+						[
+							SNew(STextBlock)
+							.Text(LOCTEXT("GridMapBatchStrokes", "Place on release"))
+							.Font(FGridMapStyleSet::StandardFont)
+						]
+					]
+				]
 			]
 		];
 }
@@ -285,6 +305,21 @@ bool SGridMapEditorToolkitWidget::IsSelectTool() const
 	return GridMapEditorMode->UISettings.GetSelectToolSelected();
 }
 
+bool SGridMapEditorToolkitWidget::IsRectangleTool() const
+{
+	return GridMapEditorMode->UISettings.GetRectangleToolSelected();
+}
+
+bool SGridMapEditorToolkitWidget::IsLineTool() const
+{
+	return GridMapEditorMode->UISettings.GetLineToolSelected();
+}
+
+bool SGridMapEditorToolkitWidget::IsFillTool() const
+{
+	return GridMapEditorMode->UISettings.GetFillToolSelected();
+}
+
 bool SGridMapEditorToolkitWidget::IsSettingsTool() const
 {
 	return GridMapEditorMode->UISettings.GetSettingsToolSelected();
@@ -304,7 +339,7 @@ void SGridMapEditorToolkitWidget::OnChangeTileSet(UObject* NewAsset)
 {
 	if (UGridMapTileSet* NewTileSet = Cast<UGridMapTileSet>(NewAsset))
 	{
-		GridMapEditorMode->UISettings.SetCurrentTileSet(NewTileSet);
+		GridMapEditorMode->SetActiveTileSet(NewTileSet);
 	}
 }
 
@@ -324,6 +359,15 @@ ECheckBoxState SGridMapEditorToolkitWidget::GetCheckState_HideOwnedActors() cons
 	return GridMapEditorMode->UISettings.GetHideOwnedActors() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
 }
 
+void SGridMapEditorToolkitWidget::OnCheckStateChanged_BatchStrokes(ECheckBoxState InState)
+{
+	GridMapEditorMode->UISettings.SetBatchStrokes(InState == ECheckBoxState::Checked ? true : false);
+}
+
+ECheckBoxState SGridMapEditorToolkitWidget::GetCheckState_BatchStrokes() const
+{
+	return GridMapEditorMode->UISettings.GetBatchStrokes() ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
 
 FText SGridMapEditorToolkitWidget::GetActiveToolName() const
 {
@@ -332,6 +376,18 @@ FText SGridMapEditorToolkitWidget::GetActiveToolName() const
 	{
 		return Commands.SetPaintTiles->GetLabel();
 	}
+	else if (IsRectangleTool())
+	{
+		return Commands.SetRectangleTiles->GetLabel();
+	}
+	else if (IsLineTool())
+	{
+		return Commands.SetLineTiles->GetLabel();
+	}
+	else if (IsFillTool())
+	{
+		return Commands.SetFillTiles->GetLabel();
+	}
 	else if (IsSelectTool())
 	{
 		return Commands.SetSelectTiles->GetLabel();
@@ -350,10 +406,6 @@ FText SGridMapEditorToolkitWidget::GetActiveToolName() const
 	{
 		OutText = LOCTEXT("FoliageToolName_LassoSelect", "Lasso Select");
 	}
-	else if (IsPaintFillTool())
-	{
-		OutText = LOCTEXT("FoliageToolName_Fill", "Fill");
-	}
 	*/
 
 	return FText::GetEmpty();
@@ -376,7 +428,7 @@ FText SGridMapEditorToolkitWidget::GetGridMapEditorErrorText() const
 
 EVisibility SGridMapEditorToolkitWidget::GetVisibility_PaintOptions() const
 {
-	if (IsPaintTool())
+	if (IsPaintTool() || IsRectangleTool() || IsLineTool() || IsFillTool())
 	{
 		return EVisibility::Visible;
 	}
@@ -28,6 +28,9 @@ private:
 	bool IsGridMapEditorEnabled() const;
 	bool IsPaintTool() const;
 	bool IsSelectTool() const;
+	bool IsRectangleTool() const;
+	bool IsLineTool() const;
+	bool IsFillTool() const;
 	bool IsSettingsTool() const;
 
 	FText GetActiveToolName() const;
@@ -42,6 +45,9 @@ private:
 
 	void OnCheckStateChanged_HideOwnedActors(ECheckBoxState InState);
 	ECheckBoxState GetCheckState_HideOwnedActors() const;
+
+	void OnCheckStateChanged_BatchStrokes(ECheckBoxState InState);
+	ECheckBoxState GetCheckState_BatchStrokes() const;
 	
 	// helper for visibilities
 	EVisibility GetVisibility_PaintOptions() const;
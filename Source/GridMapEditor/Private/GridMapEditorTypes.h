@@ -15,3 +15,13 @@ enum class EGridMapPaintMode : uint8
 	Paint,
 	Erase,
 };
+
+enum class EGridMapTileLabelMode : uint8
+{
+	/** SM_<TileSet>_<X>_<Y>_<Z>, there's only ever one tile per cell */
+	Cell,
+	/** SM_<TileSet>_<N>, from a per tile set counter */
+	Counter,
+	/** SM_<TileSet> made unique against every other label in the level, slow on big maps */
+	Unique,
+};
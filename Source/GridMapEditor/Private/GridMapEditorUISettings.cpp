@@ -4,8 +4,15 @@
 FGridMapEditorUISettings::FGridMapEditorUISettings()
 	: bPaintToolSelected(true)
 	, bSelectToolSelected(false)
+	, bRectangleToolSelected(false)
+	, bLineToolSelected(false)
+	, bFillToolSelected(false)
 	, bSettingsToolSelected(false)
 	, PaintOrigin(FVector::ZeroVector)
 	, bHideOwnedActors(false)
+	, bBatchStrokes(true)
+	, TileLabelMode(EGridMapTileLabelMode::Cell)
+	, bTimeSliceRebuilds(true)
+	, RebuildBudgetMs(8.f)
 	, bDebugDrawUpdatedTiles(false)
 {}
\ No newline at end of file
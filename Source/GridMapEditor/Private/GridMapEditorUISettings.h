@@ -15,6 +15,18 @@ public:
 	bool GetSelectToolSelected() const { return bSelectToolSelected ? true : false; }
 	void SetSelectToolSelected(bool bInSelectToolSelected) { bSelectToolSelected = bInSelectToolSelected; }
 
+	bool GetRectangleToolSelected() const { return bRectangleToolSelected; }
+	void SetRectangleToolSelected(bool bInRectangleToolSelected) { bRectangleToolSelected = bInRectangleToolSelected; }
+
+	bool GetLineToolSelected() const { return bLineToolSelected; }
+	void SetLineToolSelected(bool bInLineToolSelected) { bLineToolSelected = bInLineToolSelected; }
+
+	bool GetFillToolSelected() const { return bFillToolSelected; }
+	void SetFillToolSelected(bool bInFillToolSelected) { bFillToolSelected = bInFillToolSelected; }
+
+	/** True for any of the tools that place tiles */
+	bool GetAnyPaintToolSelected() const { return bPaintToolSelected || bRectangleToolSelected || bLineToolSelected || bFillToolSelected; }
+
 	bool GetSettingsToolSelected() const { return bSettingsToolSelected; }
 	void SetSettingsToolSelected(bool bInSettingsToolSelected) { bSettingsToolSelected = bInSettingsToolSelected; }
 
@@ -30,17 +42,37 @@ public:
 	TWeakObjectPtr<class UGridMapTileSet> GetCurrentTileSet() const { return CurrentTileSetPtr; }
 	void SetCurrentTileSet(class UGridMapTileSet* NewTileSet) { CurrentTileSetPtr = NewTileSet; }
 
+	EGridMapTileLabelMode GetTileLabelMode() const { return TileLabelMode; }
+	void SetTileLabelMode(EGridMapTileLabelMode InTileLabelMode) { TileLabelMode = InTileLabelMode; }
+
+	bool GetBatchStrokes() const { return bBatchStrokes; }
+	void SetBatchStrokes(bool bInBatchStrokes) { bBatchStrokes = bInBatchStrokes; }
+
+	/** Build All Tiles runs over several frames instead of all at once */
+	bool GetTimeSliceRebuilds() const { return bTimeSliceRebuilds; }
+	void SetTimeSliceRebuilds(bool bInTimeSliceRebuilds) { bTimeSliceRebuilds = bInTimeSliceRebuilds; }
+
+	float GetRebuildBudgetMs() const { return RebuildBudgetMs; }
+	void SetRebuildBudgetMs(float InRebuildBudgetMs) { RebuildBudgetMs = FMath::Max(InRebuildBudgetMs, 1.f); }
+
 	bool GetDebugDrawTiles() const { return bDebugDrawUpdatedTiles; }
 	void SetDebugDrawTiles(bool bInDebugDrawUpdatedTiles) { bDebugDrawUpdatedTiles = bInDebugDrawUpdatedTiles; }
 
 private:
 	bool bPaintToolSelected;
 	bool bSelectToolSelected;
+	bool bRectangleToolSelected;
+	bool bLineToolSelected;
+	bool bFillToolSelected;
 	bool bSettingsToolSelected;
 
 	FVector PaintOrigin;
 	EGridMapPaintMode PaintMode;
 	bool bHideOwnedActors;
+	bool bBatchStrokes;
+	EGridMapTileLabelMode TileLabelMode;
+	bool bTimeSliceRebuilds;
+	float RebuildBudgetMs;
 
 	bool bDebugDrawUpdatedTiles;
 
@@ -0,0 +1,155 @@
+#include "GridMapMaskKernel.h"
+#include "GridMapData.h"
+#include "GridMapTileSetCompatibility.h"
+#include "TileSet.h"
+
+/** A chunk plus a one cell border taken from the chunks around it */
+static constexpr int32 WindowSize = UGridMapData::ChunkSize + 2;
+
+/** Bits 0..ChunkSize-1 of a window row shifted so bit X lines up with cell X, offset by DeltaX */
+static FORCEINLINE uint32 AlignRow(uint64 WindowRow, int32 DeltaX)
+{
+	return (uint32)(WindowRow >> (1 + DeltaX));
+}
+
+FGridMapMaskKernel::FGridMapMaskKernel(const UGridMapData& InData)
+	: Data(InData)
+{
+	check(IsInGameThread());
+
+	FGridMapTileSetCompatibility& Compatibility = FGridMapTileSetCompatibility::Get();
+
+	// id 0 is an empty cell
+	const int32 NumIds = Data.GetNumTileSets() + 1;
+	CompatibilityIds.Init(INDEX_NONE, NumIds);
+	MatchesEmpty.Init(false, NumIds);
+
+	for (int32 TileSetId = 1; TileSetId < NumIds; ++TileSetId)
+	{
+		if (const UGridMapTileSet* TileSet = Data.GetTileSetById(TileSetId))
+		{
+			CompatibilityIds[TileSetId] = Compatibility.GetTileSetId(TileSet);
+			MatchesEmpty[TileSetId] = TileSet->bMatchesEmpty;
+		}
+	}
+}
+
+void FGridMapMaskKernel::ComputeChunk(const FGridMapDataChunk& Chunk, uint8* OutMasks) const
+{
+	static_assert(WindowSize <= 64, "a window row has to fit in 64 bits");
+
+	const int32 ChunkSize = UGridMapData::ChunkSize;
+	const FGridMapTileSetCompatibility& Compatibility = FGridMapTileSetCompatibility::Get();
+
+	FMemory::Memzero(OutMasks, UGridMapData::CellsPerChunk);
+	if (Chunk.NumTiles == 0)
+		return;
+
+	// the chunk and its 8 neighbours, for the border
+	const FGridMapDataChunk* Chunks[3][3];
+	for (int32 Y = 0; Y < 3; ++Y)
+	{
+		for (int32 X = 0; X < 3; ++X)
+		{
+			Chunks[Y][X] = (X == 1 && Y == 1) ? &Chunk : Data.FindChunk(Chunk.ChunkCoord + FIntVector(X - 1, Y - 1, 0));
+		}
+	}
+
+	// tile set ids that show up in the window, each gets a slot with a bitboard per row
+	TArray<int32, TInlineAllocator<16>> SlotIds;
+	TArray<int32, TInlineAllocator<64>> SlotById;
+	SlotById.Init(INDEX_NONE, CompatibilityIds.Num());
+	TArray<uint64, TInlineAllocator<WindowSize * 4>> Occupancy;
+
+	for (int32 WindowY = 0; WindowY < WindowSize; ++WindowY)
+	{
+		const int32 CellY = WindowY - 1;
+		const int32 ChunkY = CellY < 0 ? 0 : (CellY >= ChunkSize ? 2 : 1);
+		const int32 LocalY = (CellY + ChunkSize) % ChunkSize;
+
+		for (int32 WindowX = 0; WindowX < WindowSize; ++WindowX)
+		{
+			const int32 CellX = WindowX - 1;
+			const int32 ChunkX = CellX < 0 ? 0 : (CellX >= ChunkSize ? 2 : 1);
+			const int32 LocalX = (CellX + ChunkSize) % ChunkSize;
+
+			const FGridMapDataChunk* WindowChunk = Chunks[ChunkY][ChunkX];
+			int32 TileSetId = WindowChunk ? WindowChunk->TileSetIds[LocalX + LocalY * ChunkSize] : 0;
+			if (!SlotById.IsValidIndex(TileSetId))
+			{
+				// a tile set added since the kernel was set up, treat it like an unknown one
+				TileSetId = 0;
+			}
+
+			int32& Slot = SlotById[TileSetId];
+			if (Slot == INDEX_NONE)
+			{
+				Slot = SlotIds.Add(TileSetId);
+				Occupancy.AddZeroed(WindowSize);
+			}
+			Occupancy[Slot * WindowSize + WindowY] |= uint64(1) << WindowX;
+		}
+	}
+
+	uint64 Compatible[WindowSize];
+	for (int32 OwnerSlot = 0; OwnerSlot < SlotIds.Num(); ++OwnerSlot)
+	{
+		const int32 OwnerId = SlotIds[OwnerSlot];
+		if (OwnerId == 0 || CompatibilityIds[OwnerId] == INDEX_NONE)
+			continue;
+
+		// where the owner's requirements are met, empty cells included if it matches those
+		FMemory::Memzero(Compatible);
+		for (int32 Slot = 0; Slot < SlotIds.Num(); ++Slot)
+		{
+			const int32 NeighbourId = SlotIds[Slot];
+			// a tile set that's gone counts as an empty cell, like it does everywhere else
+			const bool bCompatible = NeighbourId == 0 || CompatibilityIds[NeighbourId] == INDEX_NONE
+				? MatchesEmpty[OwnerId]
+				: Compatibility.IsCompatible(CompatibilityIds[OwnerId], CompatibilityIds[NeighbourId]);
+			if (!bCompatible)
+				continue;
+
+			const uint64* Rows = &Occupancy[Slot * WindowSize];
+			for (int32 WindowY = 0; WindowY < WindowSize; ++WindowY)
+			{
+				Compatible[WindowY] |= Rows[WindowY];
+			}
+		}
+
+		const uint64* OwnerRows = &Occupancy[OwnerSlot * WindowSize];
+		for (int32 Y = 0; Y < ChunkSize; ++Y)
+		{
+			const int32 WindowY = Y + 1;
+			uint32 Owned = AlignRow(OwnerRows[WindowY], 0);
+			if (Owned == 0)
+				continue;
+
+			// same order as the neighbour bits: top, left, right, bottom, then the corners
+			const uint32 Planes[8] = {
+				AlignRow(Compatible[WindowY - 1], 0),
+				AlignRow(Compatible[WindowY], -1),
+				AlignRow(Compatible[WindowY], 1),
+				AlignRow(Compatible[WindowY + 1], 0),
+				AlignRow(Compatible[WindowY - 1], -1),
+				AlignRow(Compatible[WindowY - 1], 1),
+				AlignRow(Compatible[WindowY + 1], -1),
+				AlignRow(Compatible[WindowY + 1], 1),
+			};
+
+			uint8* RowMasks = OutMasks + Y * ChunkSize;
+			while (Owned)
+			{
+				const uint32 X = FMath::CountTrailingZeros(Owned);
+				Owned &= Owned - 1;
+
+				uint8 Mask = 0;
+				for (int32 Bit = 0; Bit < 8; ++Bit)
+				{
+					Mask |= ((Planes[Bit] >> X) & 1) << Bit;
+				}
+				RowMasks[X] = Mask;
+			}
+		}
+	}
+}
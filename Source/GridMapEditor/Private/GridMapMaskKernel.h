@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UGridMapData;
+struct FGridMapDataChunk;
+
+/**
+ * Works out the neighbour mask of every cell in a chunk at once. Each tile
+ * set gets a bitboard per row of where it is, those are combined into rows of
+ * where each tile set's requirements are met, and shifting those rows gives
+ * all 8 neighbour bits for a whole row of cells. Corner bits are left as they
+ * are, the tile set's adjacency lookup takes care of ignoring the ones a tile
+ * doesn't care about, same as for masks worked out one cell at a time.
+ */
+class FGridMapMaskKernel
+{
+public:
+	/** Sets up for the data's current tile sets, must be called on the game thread */
+	explicit FGridMapMaskKernel(const UGridMapData& InData);
+
+	/**
+	 * Writes the mask of every cell in the chunk to OutMasks, which is indexed
+	 * like the chunk's arrays. Empty cells get 0. Safe to call from any thread.
+	 */
+	void ComputeChunk(const FGridMapDataChunk& Chunk, uint8* OutMasks) const;
+
+private:
+	const UGridMapData& Data;
+
+	/** Compatibility id of each tile set, by tile set id */
+	TArray<int32> CompatibilityIds;
+	/** Whether each tile set matches empty cells, by tile set id */
+	TArray<bool> MatchesEmpty;
+};
@@ -0,0 +1,189 @@
+#include "GridMapMeshStreamer.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GridMapStaticMeshActor.h"
+#include "GridMapStats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "TileSet.h"
+
+FGridMapMeshStreamer::FGridMapMeshStreamer()
+	: PlaceholderMesh(nullptr)
+{
+}
+
+FGridMapMeshStreamer::~FGridMapMeshStreamer()
+{
+	CancelAll();
+}
+
+DECLARE_CYCLE_STAT(TEXT("Load Synchronous (Streamer)"), STAT_GridMap_StreamerLoadSynchronous, STATGROUP_GridMap);
+
+void FGridMapMeshStreamer::SetTileMesh(AGridMapStaticMeshActor* Tile, const TSoftObjectPtr<UStaticMesh>& StaticMesh)
+{
+	if (Tile == nullptr)
+		return;
+
+	// already loaded (or nothing to load), no need to wait
+	UStaticMesh* LoadedMesh = StaticMesh.Get();
+	if (LoadedMesh || StaticMesh.IsNull())
+	{
+		PendingTiles.Remove(Tile);
+		Tile->GetStaticMeshComponent()->SetStaticMesh(LoadedMesh);
+		return;
+	}
+
+	const FSoftObjectPath MeshPath = StaticMesh.ToSoftObjectPath();
+	PendingTiles.Add(Tile, MeshPath);
+	QueuedMeshes.Add(MeshPath);
+
+	Tile->GetStaticMeshComponent()->SetStaticMesh(PlaceholderMesh);
+}
+
+FSoftObjectPath FGridMapMeshStreamer::GetTileMesh(const AGridMapStaticMeshActor* Tile) const
+{
+	if (const FSoftObjectPath* PendingMesh = PendingTiles.Find(Tile))
+		return *PendingMesh;
+
+	return FSoftObjectPath(Tile->GetStaticMeshComponent()->GetStaticMesh());
+}
+
+void FGridMapMeshStreamer::FlushRequests()
+{
+	if (QueuedMeshes.Num() == 0)
+		return;
+
+	TSharedPtr<FStreamableHandle> Request = StreamableManager.RequestAsyncLoad(QueuedMeshes.Array(), FStreamableDelegate::CreateRaw(this, &FGridMapMeshStreamer::OnMeshesLoaded));
+	QueuedMeshes.Reset();
+
+	if (Request.IsValid() && !Request->HasLoadCompleted())
+	{
+		ActiveRequests.Add(Request);
+	}
+}
+
+void FGridMapMeshStreamer::FlushRequestsSynchronous()
+{
+	// meshes in a batch that's still in flight count too, or their tiles would keep the placeholder
+	for (const TPair<TWeakObjectPtr<AGridMapStaticMeshActor>, FSoftObjectPath>& PendingTile : PendingTiles)
+	{
+		if (PendingTile.Value.ResolveObject() == nullptr)
+		{
+			QueuedMeshes.Add(PendingTile.Value);
+		}
+	}
+
+	if (QueuedMeshes.Num() > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GridMap_StreamerLoadSynchronous);
+		TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_LoadSynchronous);
+		StreamableManager.RequestSyncLoad(QueuedMeshes.Array());
+		QueuedMeshes.Reset();
+	}
+
+	ApplyLoadedMeshes();
+}
+
+bool FGridMapMeshStreamer::IsShowingPlaceholder(const AGridMapStaticMeshActor* Tile) const
+{
+	return IsValid(Tile) && PlaceholderMesh && Tile->GetStaticMeshComponent()->GetStaticMesh() == PlaceholderMesh && !PendingTiles.Contains(Tile);
+}
+
+void FGridMapMeshStreamer::CancelAll()
+{
+	for (const TSharedPtr<FStreamableHandle>& Request : ActiveRequests)
+	{
+		if (Request.IsValid())
+		{
+			Request->CancelHandle();
+		}
+	}
+
+	ActiveRequests.Reset();
+	QueuedMeshes.Reset();
+	PendingTiles.Reset();
+
+	for (const TPair<TObjectKey<UGridMapTileSet>, TSharedPtr<FStreamableHandle>>& Preload : TileSetPreloads)
+	{
+		if (Preload.Value.IsValid())
+		{
+			Preload.Value->ReleaseHandle();
+		}
+	}
+	TileSetPreloads.Reset();
+}
+
+void FGridMapMeshStreamer::PreloadTileSet(const UGridMapTileSet* TileSet)
+{
+	if (TileSet == nullptr || TileSetPreloads.Contains(TileSet))
+		return;
+
+	TArray<FSoftObjectPath> MeshPaths;
+	for (const FGridMapTileList& TileList : TileSet->Tiles)
+	{
+		for (const TSoftObjectPtr<UStaticMesh>& Tile : TileList.Tiles)
+		{
+			if (!Tile.IsNull())
+			{
+				MeshPaths.AddUnique(Tile.ToSoftObjectPath());
+			}
+		}
+	}
+
+	if (MeshPaths.Num() == 0)
+		return;
+
+	// any tiles waiting on these meshes can be picked up as soon as they arrive
+	TSharedPtr<FStreamableHandle> Preload = StreamableManager.RequestAsyncLoad(MeshPaths, FStreamableDelegate::CreateRaw(this, &FGridMapMeshStreamer::OnMeshesLoaded), FStreamableManager::AsyncLoadHighPriority, true);
+	TileSetPreloads.Add(TileSet, Preload);
+}
+
+void FGridMapMeshStreamer::ReleaseTileSet(const UGridMapTileSet* TileSet)
+{
+	TSharedPtr<FStreamableHandle> Preload;
+	if (TileSetPreloads.RemoveAndCopyValue(TileSet, Preload) && Preload.IsValid())
+	{
+		Preload->ReleaseHandle();
+	}
+}
+
+float FGridMapMeshStreamer::GetTileSetLoadProgress(const UGridMapTileSet* TileSet) const
+{
+	const TSharedPtr<FStreamableHandle>* Preload = TileSetPreloads.Find(TileSet);
+	if (Preload == nullptr || !Preload->IsValid())
+		return 1.f;
+
+	return (*Preload)->GetProgress();
+}
+
+bool FGridMapMeshStreamer::IsTileSetLoading(const UGridMapTileSet* TileSet) const
+{
+	const TSharedPtr<FStreamableHandle>* Preload = TileSetPreloads.Find(TileSet);
+	return Preload && Preload->IsValid() && (*Preload)->IsLoadingInProgress();
+}
+
+void FGridMapMeshStreamer::OnMeshesLoaded()
+{
+	ActiveRequests.RemoveAll([](const TSharedPtr<FStreamableHandle>& Request) { return !Request.IsValid() || Request->HasLoadCompleted(); });
+
+	ApplyLoadedMeshes();
+}
+
+void FGridMapMeshStreamer::ApplyLoadedMeshes()
+{
+	for (auto It = PendingTiles.CreateIterator(); It; ++It)
+	{
+		AGridMapStaticMeshActor* Tile = It.Key().Get();
+		if (!IsValid(Tile))
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// a tile might have been requested in a later batch that hasn't landed yet
+		if (UStaticMesh* LoadedMesh = Cast<UStaticMesh>(It.Value().ResolveObject()))
+		{
+			Tile->GetStaticMeshComponent()->SetStaticMesh(LoadedMesh);
+			It.RemoveCurrent();
+		}
+	}
+}
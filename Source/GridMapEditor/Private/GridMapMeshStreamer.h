@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/SoftObjectPtr.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AGridMapStaticMeshActor;
+class UGridMapTileSet;
+class UStaticMesh;
+
+/**
+ * Streams tile meshes in the background. Tiles whose mesh isn't loaded yet
+ * show a placeholder, and get their real mesh once the batch it was
+ * requested in arrives.
+ */
+class FGridMapMeshStreamer
+{
+public:
+	FGridMapMeshStreamer();
+	~FGridMapMeshStreamer();
+
+	void SetPlaceholderMesh(UStaticMesh* InPlaceholderMesh) { PlaceholderMesh = InPlaceholderMesh; }
+
+	/** Assigns the mesh to the tile right away if it's loaded, otherwise shows the placeholder and queues a load */
+	void SetTileMesh(AGridMapStaticMeshActor* Tile, const TSoftObjectPtr<UStaticMesh>& StaticMesh);
+
+	/** The mesh the tile will end up with, which may still be loading */
+	FSoftObjectPath GetTileMesh(const AGridMapStaticMeshActor* Tile) const;
+
+	/** Sends every mesh queued since the last flush off as a single async request */
+	void FlushRequests();
+
+	/** Loads everything that's pending right now, including requests already in flight, for when there's no tick to wait for */
+	void FlushRequestsSynchronous();
+
+	/** True if the tile shows the placeholder without a load pending for it, ie. undo brought the placeholder back */
+	bool IsShowingPlaceholder(const AGridMapStaticMeshActor* Tile) const;
+
+	/** Drops all pending loads, tiles keep whatever mesh they currently show */
+	void CancelAll();
+
+	int32 GetNumPending() const { return PendingTiles.Num(); }
+
+	/** Starts loading every mesh in the tile set, and keeps them loaded until it's released */
+	void PreloadTileSet(const UGridMapTileSet* TileSet);
+	void ReleaseTileSet(const UGridMapTileSet* TileSet);
+
+	/** 0..1 progress of the tile set's preload, 1 if it isn't being preloaded */
+	float GetTileSetLoadProgress(const UGridMapTileSet* TileSet) const;
+	bool IsTileSetLoading(const UGridMapTileSet* TileSet) const;
+
+private:
+	void OnMeshesLoaded();
+	void ApplyLoadedMeshes();
+
+	FStreamableManager StreamableManager;
+	UStaticMesh* PlaceholderMesh;
+
+	/** Tiles waiting on their mesh */
+	TMap<TWeakObjectPtr<AGridMapStaticMeshActor>, FSoftObjectPath> PendingTiles;
+
+	/** Meshes that haven't been requested yet */
+	TSet<FSoftObjectPath> QueuedMeshes;
+
+	TArray<TSharedPtr<FStreamableHandle>> ActiveRequests;
+
+	/** Keeps each preloaded tile set's meshes resident */
+	TMap<TObjectKey<UGridMapTileSet>, TSharedPtr<FStreamableHandle>> TileSetPreloads;
+};
@@ -0,0 +1,476 @@
+#include "GridMapRebuild.h"
+#include "Async/ParallelFor.h"
+#include "Components/StaticMeshComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GridMapCellIndex.h"
+#include "GridMapChunkActor.h"
+#include "GridMapData.h"
+#include "GridMapMaskKernel.h"
+#include "GridMapMeshStreamer.h"
+#include "GridMapStaticMeshActor.h"
+#include "GridMapStats.h"
+#include "GridMapTileSetCompatibility.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "TileSet.h"
+
+static const int32 NeighbourCount = 8;
+
+static const FIntVector NeighbourOffsets[NeighbourCount]{
+	FIntVector(0, -1, 0),	// top-center
+	FIntVector(-1, 0, 0),	// center-left
+	FIntVector(1, 0, 0),	// center-right
+	FIntVector(0, 1, 0),	// botton-center
+
+	FIntVector(-1, -1, 0),	// top left
+	FIntVector(1, -1, 0),	// top right
+	FIntVector(-1, 1, 0),	// bottom left
+	FIntVector(1, 1, 0),	// bottom right
+};
+
+DECLARE_CYCLE_STAT(TEXT("Rebuild Gather"), STAT_GridMap_RebuildGather, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Rebuild Compute"), STAT_GridMap_RebuildCompute, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Rebuild Masks"), STAT_GridMap_RebuildMasks, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Rebuild Apply"), STAT_GridMap_RebuildApply, STATGROUP_GridMap);
+DECLARE_CYCLE_STAT(TEXT("Load Synchronous (Rebuild)"), STAT_GridMap_LoadSynchronous, STATGROUP_GridMap);
+
+void FGridMapRebuild::Gather(UWorld* InWorld, const FGridMapCellIndex& Index, const FGridMapMeshStreamer* MeshStreamer)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildGather);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildGather);
+
+	check(IsInGameThread());
+
+	Reset(InWorld, Index);
+	if (World == nullptr)
+		return;
+
+	// the grid data has every cell, tile actors are only needed to apply the changes to
+	if (Data)
+	{
+		Tiles.Reserve(Data->Num());
+		TileIndexByCell.Reserve(Data->Num());
+
+		for (const FGridMapDataChunk& Chunk : Data->GetChunks())
+		{
+			for (int32 ChunkIndex = 0; ChunkIndex < UGridMapData::CellsPerChunk; ++ChunkIndex)
+			{
+				if (Chunk.TileSetIds[ChunkIndex] == 0)
+					continue;
+
+				const FIntVector Cell = UGridMapData::ChunkIndexToCell(Chunk.ChunkCoord, ChunkIndex);
+				AddTile(Index, Data->GetTileSetById(Chunk.TileSetIds[ChunkIndex]), Cell, true, MeshStreamer);
+			}
+		}
+		return;
+	}
+
+	// without grid data the index's tiles are all there is, pooled ones are never in it
+	for (const TPair<TWeakObjectPtr<AGridMapStaticMeshActor>, FIntVector>& Tile : Index.GetTiles())
+	{
+		AGridMapStaticMeshActor* Actor = Tile.Key.Get();
+		if (IsValid(Actor) && Index.Find(Tile.Value) == Actor)
+		{
+			AddTile(Index, Actor->TileSet, Tile.Value, true, MeshStreamer);
+		}
+	}
+}
+
+void FGridMapRebuild::GatherCells(UWorld* InWorld, const FGridMapCellIndex& Index, const TSet<FIntVector>& Cells, const FGridMapMeshStreamer* MeshStreamer, bool bResolveUnchanged)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildGather);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildGather);
+
+	check(IsInGameThread());
+
+	Reset(InWorld, Index);
+	if (World == nullptr)
+		return;
+
+	for (const FIntVector& Cell : Cells)
+	{
+		const int32 TileIndex = AddTile(Index, Index.GetTileSet(Cell), Cell, true, MeshStreamer);
+
+		FGridMapCell CellData;
+		if (!bResolveUnchanged && TileIndex != INDEX_NONE && Data && Data->GetCell(Cell, CellData) && CellData.IsResolved())
+		{
+			Tiles[TileIndex].Cached = { CellData.TileList, CellData.Variant, CellData.Mask };
+		}
+	}
+
+	for (const FIntVector& Cell : Cells)
+	{
+		for (int32 i = 0; i < NeighbourCount; ++i)
+		{
+			const FIntVector NeighbourCell = Cell + NeighbourOffsets[i];
+			if (!TileIndexByCell.Contains(NeighbourCell))
+			{
+				AddTile(Index, Index.GetTileSet(NeighbourCell), NeighbourCell, false, MeshStreamer);
+			}
+		}
+	}
+}
+
+void FGridMapRebuild::GatherChunk(UWorld* InWorld, const FGridMapCellIndex& Index, const FIntVector& ChunkCoord, const FGridMapMeshStreamer* MeshStreamer)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildGather);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildGather);
+
+	check(IsInGameThread());
+
+	Reset(InWorld, Index);
+	if (World == nullptr || Data == nullptr)
+		return;
+
+	const FGridMapDataChunk* Chunk = Data->FindChunk(ChunkCoord);
+	if (Chunk == nullptr)
+		return;
+
+	// every tile in the chunk gets its mask from the kernel, which reads the
+	// neighbouring chunks itself, so there's no need to gather a border
+	for (int32 ChunkIndex = 0; ChunkIndex < UGridMapData::CellsPerChunk; ++ChunkIndex)
+	{
+		if (Chunk->TileSetIds[ChunkIndex] == 0)
+			continue;
+
+		const FIntVector Cell = UGridMapData::ChunkIndexToCell(ChunkCoord, ChunkIndex);
+		AddTile(Index, Data->GetTileSetById(Chunk->TileSetIds[ChunkIndex]), Cell, true, MeshStreamer);
+	}
+}
+
+void FGridMapRebuild::AddCellAndNeighbours(const FIntVector& Cell, TSet<FIntVector>& OutCells)
+{
+	OutCells.Add(Cell);
+	for (int32 i = 0; i < NeighbourCount; ++i)
+	{
+		OutCells.Add(Cell + NeighbourOffsets[i]);
+	}
+}
+
+uint32 FGridMapRebuild::GetAdjacencyBitmask(const UGridMapTileSet* TileSet, const FIntVector& Cell, TFunctionRef<const UGridMapTileSet*(const FIntVector&)> GetTileSetAt)
+{
+	FGridMapTileSetCompatibility& Compatibility = FGridMapTileSetCompatibility::Get();
+	uint32 bitmask = 0;
+
+	for (int32 i = 0; i < NeighbourCount; ++i)
+	{
+		const UGridMapTileSet* NeighbourTileSet = GetTileSetAt(Cell + NeighbourOffsets[i]);
+		if (NeighbourTileSet)
+		{
+			if (Compatibility.IsCompatible(TileSet, NeighbourTileSet))
+				bitmask |= 1 << i;
+		}
+		else if (TileSet->bMatchesEmpty)
+		{
+			bitmask |= 1 << i;
+		}
+	}
+
+	return bitmask;
+}
+
+void FGridMapRebuild::Reset(UWorld* InWorld, const FGridMapCellIndex& Index)
+{
+	World = InWorld;
+	Data = Index.GetData();
+	if (Data)
+	{
+		// resolves against a tile set that's been edited since can't be trusted
+		Data->InvalidateStaleResolves();
+	}
+	Tiles.Reset();
+	TileIndexByCell.Reset();
+	NumToResolve = 0;
+	Changes.Reset();
+	Unresolved.Reset();
+	UnresolvedMasks.Reset();
+	Resolved.Reset();
+	MaskChunks.Reset();
+	MaskChunkSlots.Reset();
+	ChunkMasks.Reset();
+}
+
+int32 FGridMapRebuild::AddTile(const FGridMapCellIndex& Index, const UGridMapTileSet* TileSet, const FIntVector& Cell, bool bResolve, const FGridMapMeshStreamer* MeshStreamer)
+{
+	if (TileSet == nullptr)
+		return INDEX_NONE;
+
+	// cells with neither an actor nor an instance still count as neighbours, there's just nothing to update
+	AGridMapStaticMeshActor* Actor = Index.Find(Cell);
+	AGridMapChunkActor* Chunk = Actor ? nullptr : Index.FindChunk(Cell);
+	const bool bHasActor = Actor != nullptr;
+
+	FGridMapRebuildTile& Tile = Tiles.AddDefaulted_GetRef();
+	Tile.Actor = Actor;
+	Tile.Chunk = Chunk;
+	Tile.Cell = Cell;
+	Tile.TileSet = TileSet;
+	Tile.TileSetId = FGridMapTileSetCompatibility::Get().GetTileSetId(TileSet);
+	if (bHasActor)
+	{
+		Tile.CurrentMesh = MeshStreamer ? MeshStreamer->GetTileMesh(Actor) : FSoftObjectPath(Actor->GetStaticMeshComponent()->GetStaticMesh());
+		Tile.CurrentRotation = Actor->GetActorRotation();
+	}
+	else if (Chunk)
+	{
+		Tile.CurrentMesh = FSoftObjectPath(Chunk->GetTileMesh(Cell));
+		Tile.CurrentRotation = Chunk->GetTileRotation(Cell);
+	}
+	Tile.bResolve = bResolve && (bHasActor || Chunk);
+	Tile.Cached = { INDEX_NONE, INDEX_NONE, 0 };
+	NumToResolve += Tile.bResolve ? 1 : 0;
+
+	// masks of cells that are in the grid data come from the kernel
+	Tile.MaskIndex = INDEX_NONE;
+	if (Data && Tile.bResolve)
+	{
+		const FIntVector ChunkCoord = UGridMapData::CellToChunk(Cell);
+		int32 ChunkSlot;
+		if (const int32* ExistingSlot = MaskChunkSlots.Find(ChunkCoord))
+		{
+			ChunkSlot = *ExistingSlot;
+		}
+		else
+		{
+			ChunkSlot = MaskChunks.Add(ChunkCoord);
+			MaskChunkSlots.Add(ChunkCoord, ChunkSlot);
+		}
+		Tile.MaskIndex = ChunkSlot * UGridMapData::CellsPerChunk + UGridMapData::CellToChunkIndex(Cell);
+	}
+
+	TileIndexByCell.Add(Cell, Tiles.Num() - 1);
+	return Tiles.Num() - 1;
+}
+
+void FGridMapRebuild::Compute(int32 Seed)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildCompute);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildCompute);
+
+	Changes.Reset();
+	Unresolved.Reset();
+	UnresolvedMasks.Reset();
+
+	const int32 NumTasks = FMath::DivideAndRoundUp(Tiles.Num(), TilesPerTask);
+
+	// each task writes into its own lists, which are stitched together in
+	// task order afterwards so the result doesn't depend on scheduling
+	TArray<TArray<FGridMapTileChange>> TaskChanges;
+	TArray<TArray<int32>> TaskUnresolved;
+	TArray<int32> TaskUnchanged;
+	TaskChanges.SetNum(NumTasks);
+	TaskUnresolved.SetNum(NumTasks);
+	TaskUnchanged.SetNumZeroed(NumTasks);
+
+	ComputeChunkMasks();
+
+	// every tile's slot is only ever written by the task that owns it
+	Resolved.SetNumUninitialized(Tiles.Num());
+
+	ParallelFor(NumTasks, [this, Seed, &TaskChanges, &TaskUnresolved, &TaskUnchanged](int32 TaskIndex)
+	{
+		const int32 FirstTile = TaskIndex * TilesPerTask;
+		const int32 LastTile = FMath::Min(FirstTile + TilesPerTask, Tiles.Num());
+
+		for (int32 TileIndex = FirstTile; TileIndex < LastTile; ++TileIndex)
+		{
+			const FGridMapRebuildTile& Tile = Tiles[TileIndex];
+			if (!Tile.bResolve)
+				continue;
+
+			FGridMapCellResolve& Resolve = Resolved[TileIndex];
+			Resolve.Mask = Tile.MaskIndex != INDEX_NONE ? ChunkMasks[Tile.MaskIndex] : (uint8)GetAdjacencyBitmask(Tile);
+
+			// the mask takes the compatibility matrix into account, so an unchanged one means its neighbours
+			// didn't change in any way that matters to it and the tile still shows what it resolved to
+			if (Tile.Cached.TileList != INDEX_NONE && Tile.Cached.Mask == Resolve.Mask)
+			{
+				Resolve = Tile.Cached;
+				++TaskUnchanged[TaskIndex];
+				continue;
+			}
+
+			Resolve.TileList = Tile.TileSet->FindTileListIndexForAdjacency(Resolve.Mask);
+			Resolve.Variant = INDEX_NONE;
+
+			const FGridMapTileList* TileList = Tile.TileSet->Tiles.IsValidIndex(Resolve.TileList) ? &Tile.TileSet->Tiles[Resolve.TileList] : nullptr;
+			if (TileList == nullptr)
+			{
+				TaskUnresolved[TaskIndex].Add(TileIndex);
+				continue;
+			}
+
+			Resolve.Variant = TileList->GetVariantForCell(Tile.Cell, Seed);
+
+			TSoftObjectPtr<UStaticMesh> ExpectedMesh = TileList->Tiles.IsValidIndex(Resolve.Variant) ? TileList->Tiles[Resolve.Variant] : TSoftObjectPtr<UStaticMesh>();
+			if (ExpectedMesh.ToSoftObjectPath() == Tile.CurrentMesh && Tile.CurrentRotation.Equals(TileList->Rotation))
+				continue;
+
+			TaskChanges[TaskIndex].Add({ TileIndex, ExpectedMesh, TileList->Rotation });
+		}
+	});
+
+	int32 NumUnchanged = 0;
+	for (int32 TaskIndex = 0; TaskIndex < NumTasks; ++TaskIndex)
+	{
+		Changes.Append(TaskChanges[TaskIndex]);
+		Unresolved.Append(TaskUnresolved[TaskIndex]);
+		NumUnchanged += TaskUnchanged[TaskIndex];
+	}
+
+	// a missing tile list usually fails the same way in many cells, so group them up
+	for (int32 TileIndex : Unresolved)
+	{
+		const UGridMapTileSet* TileSet = Tiles[TileIndex].TileSet;
+		const uint8 Mask = Resolved[TileIndex].Mask;
+		FGridMapUnresolvedMask* Existing = UnresolvedMasks.FindByPredicate([TileSet, Mask](const FGridMapUnresolvedMask& Other) { return Other.TileSet == TileSet && Other.Mask == Mask; });
+		if (Existing)
+		{
+			++Existing->NumTiles;
+		}
+		else
+		{
+			UnresolvedMasks.Add({ TileSet, Mask, 1 });
+		}
+	}
+	UnresolvedMasks.Sort([](const FGridMapUnresolvedMask& A, const FGridMapUnresolvedMask& B)
+	{
+		const int32 NameCompare = A.TileSet->GetName().Compare(B.TileSet->GetName());
+		return NameCompare != 0 ? NameCompare < 0 : A.Mask < B.Mask;
+	});
+
+	INC_DWORD_STAT_BY(STAT_GridMap_TilesResolved, NumToResolve);
+	INC_DWORD_STAT_BY(STAT_GridMap_TilesUnchangedMask, NumUnchanged);
+}
+
+void FGridMapRebuild::ComputeChunkMasks()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildMasks);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildMasks);
+
+	ChunkMasks.SetNumUninitialized(MaskChunks.Num() * UGridMapData::CellsPerChunk);
+	if (MaskChunks.Num() == 0)
+		return;
+
+	check(Data);
+	const FGridMapMaskKernel Kernel(*Data);
+
+	ParallelFor(MaskChunks.Num(), [this, &Kernel](int32 ChunkSlot)
+	{
+		uint8* Masks = &ChunkMasks[ChunkSlot * UGridMapData::CellsPerChunk];
+		if (const FGridMapDataChunk* Chunk = Data->FindChunk(MaskChunks[ChunkSlot]))
+		{
+			Kernel.ComputeChunk(*Chunk, Masks);
+		}
+		else
+		{
+			FMemory::Memzero(Masks, UGridMapData::CellsPerChunk);
+		}
+	});
+}
+
+void FGridMapRebuild::Apply(bool bDebugDrawTiles, FGridMapMeshStreamer* MeshStreamer)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildApply);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildApply);
+
+	check(IsInGameThread());
+
+	for (const FGridMapTileChange& Change : Changes)
+	{
+		const FGridMapRebuildTile& Tile = Tiles[Change.TileIndex];
+		if (IsValid(Tile.Chunk))
+		{
+			// the instance keeps its tile set, only what it shows changes
+			const FGridMapChunkTile* ChunkTile = Tile.Chunk->FindTile(Tile.Cell);
+			if (ChunkTile == nullptr)
+				continue;
+
+			SCOPE_CYCLE_COUNTER(STAT_GridMap_LoadSynchronous);
+			TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_LoadSynchronous);
+			Tile.Chunk->SetTile(Tile.Cell, ChunkTile->TileSet, Change.StaticMesh.LoadSynchronous(), Change.Rotation);
+			continue;
+		}
+
+		AGridMapStaticMeshActor* Actor = Tile.Actor;
+		if (!IsValid(Actor))
+			continue;
+
+		if (bDebugDrawTiles)
+		{
+			DrawDebugPoint(World, Actor->GetActorLocation(), 10.f, FColor::Yellow, false, 5.0f, 255);
+		}
+
+		// nothing to record, the mesh and rotation follow from the grid data which undo restores instead
+		Actor->MarkPackageDirty();
+
+		if (MeshStreamer)
+		{
+			MeshStreamer->SetTileMesh(Actor, Change.StaticMesh);
+		}
+		else
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GridMap_LoadSynchronous);
+			TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_LoadSynchronous);
+			Actor->GetStaticMeshComponent()->SetStaticMesh(Change.StaticMesh.LoadSynchronous());
+		}
+		Actor->SetActorRotation(Change.Rotation);
+	}
+
+	for (int32 TileIndex : Unresolved)
+	{
+		AGridMapStaticMeshActor* Actor = Tiles[TileIndex].Actor;
+		if (IsValid(Actor))
+		{
+			::DrawDebugPoint(World, Actor->GetActorLocation(), 12, FColor::Red, false, 10.f);
+		}
+	}
+
+	// remember what every cell resolved to
+	if (Data)
+	{
+		for (int32 TileIndex = 0; TileIndex < Tiles.Num(); ++TileIndex)
+		{
+			if (Tiles[TileIndex].bResolve && Resolved.IsValidIndex(TileIndex))
+			{
+				const FGridMapCellResolve& Resolve = Resolved[TileIndex];
+				Data->SetResolved(Tiles[TileIndex].Cell, Resolve.TileList, Resolve.Variant, Resolve.Mask);
+			}
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_GridMap_TilesChanged, Changes.Num());
+}
+
+void FGridMapRebuild::ReportUnresolved(int32 NumUnresolved)
+{
+	if (NumUnresolved > 0 && GEngine)
+	{
+		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 4.0f, FColor::Red, FString::Printf(TEXT("Failed to find %d tiles!"), NumUnresolved), true, FVector2D::UnitVector);
+	}
+}
+
+uint32 FGridMapRebuild::GetAdjacencyBitmask(const FGridMapRebuildTile& Tile) const
+{
+	// ids were all registered while gathering, so this only reads the matrix
+	const FGridMapTileSetCompatibility& Compatibility = FGridMapTileSetCompatibility::Get();
+	uint32 bitmask = 0;
+
+	for (int32 i = 0; i < NeighbourCount; ++i)
+	{
+		const int32* NeighbourIndex = TileIndexByCell.Find(Tile.Cell + NeighbourOffsets[i]);
+		if (NeighbourIndex)
+		{
+			if (Compatibility.IsCompatible(Tile.TileSetId, Tiles[*NeighbourIndex].TileSetId))
+				bitmask |= 1 << i;
+		}
+		else if (Tile.TileSet->bMatchesEmpty)
+		{
+			bitmask |= 1 << i;
+		}
+	}
+
+	return bitmask;
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "UObject/SoftObjectPtr.h"
+
+class AGridMapChunkActor;
+class AGridMapStaticMeshActor;
+class FGridMapCellIndex;
+class FGridMapMeshStreamer;
+class UGridMapData;
+class UGridMapTileSet;
+class UStaticMesh;
+class UWorld;
+
+/** What a tile resolved to, so it can be stored in the grid data */
+struct FGridMapCellResolve
+{
+	int32 TileList;
+	int32 Variant;
+	uint8 Mask;
+
+	bool operator==(const FGridMapCellResolve& Other) const
+	{
+		return TileList == Other.TileList && Variant == Other.Variant && Mask == Other.Mask;
+	}
+};
+
+/** Read only copy of a tile's state, safe to use off the game thread */
+struct FGridMapRebuildTile
+{
+	/** Null for cells that don't have a tile actor, ie. instanced ones */
+	AGridMapStaticMeshActor* Actor;
+	/** The chunk holding the cell's instance, null unless the cell is instanced */
+	AGridMapChunkActor* Chunk;
+	FIntVector Cell;
+	const UGridMapTileSet* TileSet;
+	/** TileSet's id in the compatibility matrix */
+	int32 TileSetId;
+	FSoftObjectPath CurrentMesh;
+	FRotator CurrentRotation;
+	/** False for tiles that are only gathered as neighbours of the tiles being resolved */
+	bool bResolve;
+	/** Where the mask kernel writes this tile's mask, INDEX_NONE to work it out one cell at a time */
+	int32 MaskIndex;
+	/** What the grid data says the cell last resolved to, TileList is INDEX_NONE if it has to be resolved regardless */
+	FGridMapCellResolve Cached;
+};
+
+/** A tile that needs a different mesh or rotation */
+struct FGridMapTileChange
+{
+	int32 TileIndex;
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
+	FRotator Rotation;
+};
+
+/** A tile set and mask that had no tile list, shared by however many tiles ran into it */
+struct FGridMapUnresolvedMask
+{
+	const UGridMapTileSet* TileSet;
+	uint8 Mask;
+	int32 NumTiles;
+};
+
+/**
+ * Rebuilds every tile in a world in two phases: a parallel compute phase
+ * that works out which tiles need to change, and a game thread apply phase
+ * that only touches the tiles that did.
+ */
+class FGridMapRebuild
+{
+public:
+	/** Number of tiles handed to each parallel task */
+	static constexpr int32 TilesPerTask = 1024;
+
+	/** Snapshots every tile in the grid data (or every tile actor if there isn't any yet), must be called on the game thread */
+	void Gather(UWorld* World, const FGridMapCellIndex& Index, const FGridMapMeshStreamer* MeshStreamer = nullptr);
+
+	/**
+	 * Snapshots the tiles in the given cells for resolving, along with their
+	 * neighbours, which are only needed to work out adjacency. A cell whose mask
+	 * comes out the same as the one the grid data says it last resolved with keeps
+	 * that resolve and its tile isn't looked at, unless bResolveUnchanged is set
+	 * (ie. the tiles were just synced from the data and may not show it yet).
+	 */
+	void GatherCells(UWorld* World, const FGridMapCellIndex& Index, const TSet<FIntVector>& Cells, const FGridMapMeshStreamer* MeshStreamer = nullptr, bool bResolveUnchanged = false);
+
+	/**
+	 * Snapshots every tile in one chunk of the grid data for resolving, regardless of
+	 * what it last resolved to. Used to rebuild the grid a piece at a time.
+	 */
+	void GatherChunk(UWorld* World, const FGridMapCellIndex& Index, const FIntVector& ChunkCoord, const FGridMapMeshStreamer* MeshStreamer = nullptr);
+
+	/** Adds the cell and its 8 neighbours, ie. every cell whose adjacency changes when this cell does */
+	static void AddCellAndNeighbours(const FIntVector& Cell, TSet<FIntVector>& OutCells);
+
+	/** Adjacency of a tile set in the cell, GetTileSetAt returns what's in a neighbouring cell (null if it's empty) */
+	static uint32 GetAdjacencyBitmask(const UGridMapTileSet* TileSet, const FIntVector& Cell, TFunctionRef<const UGridMapTileSet*(const FIntVector&)> GetTileSetAt);
+
+	/** Works out the changes for every gathered tile */
+	void Compute(int32 Seed);
+
+	/**
+	 * Applies the computed changes to the tile actors and instances, must be called on the game thread.
+	 * Meshes are streamed in through the streamer if there is one, otherwise loaded right away.
+	 * Instances always load theirs right away, a chunk has no placeholder to show in the meantime.
+	 * Nothing is recorded for the tile actors, they're only ever a view of the grid data.
+	 */
+	void Apply(bool bDebugDrawTiles, FGridMapMeshStreamer* MeshStreamer = nullptr);
+
+	/** Tells the user how many tiles had no tile list for their neighbours, once per rebuild however it was split up */
+	static void ReportUnresolved(int32 NumUnresolved);
+
+	int32 GetNumTiles() const { return Tiles.Num(); }
+	int32 GetNumChanged() const { return Changes.Num(); }
+	int32 GetNumUnresolved() const { return Unresolved.Num(); }
+	/** Every distinct tile set and mask the last Compute couldn't find a tile list for, sorted by tile set name then mask */
+	const TArray<FGridMapUnresolvedMask>& GetUnresolvedMasks() const { return UnresolvedMasks; }
+
+private:
+	void Reset(UWorld* InWorld, const FGridMapCellIndex& Index);
+	/** Returns the tile's index, or INDEX_NONE if the cell is empty. The index says which actor or instance shows the cell */
+	int32 AddTile(const FGridMapCellIndex& Index, const UGridMapTileSet* TileSet, const FIntVector& Cell, bool bResolve, const FGridMapMeshStreamer* MeshStreamer);
+	uint32 GetAdjacencyBitmask(const FGridMapRebuildTile& Tile) const;
+	/** Runs the mask kernel over every chunk with tiles to resolve, must be called on the game thread */
+	void ComputeChunkMasks();
+
+	UWorld* World = nullptr;
+	UGridMapData* Data = nullptr;
+	TArray<FGridMapRebuildTile> Tiles;
+	TMap<FIntVector, int32> TileIndexByCell;
+	int32 NumToResolve = 0;
+
+	TArray<FGridMapTileChange> Changes;
+	TArray<int32> Unresolved;
+	TArray<FGridMapUnresolvedMask> UnresolvedMasks;
+	/** One per tile, only filled in for the ones that were resolved */
+	TArray<FGridMapCellResolve> Resolved;
+
+	/** Chunks of the grid data with tiles to resolve, their masks are worked out a chunk at a time */
+	TArray<FIntVector> MaskChunks;
+	TMap<FIntVector, int32> MaskChunkSlots;
+	TArray<uint8> ChunkMasks;
+};
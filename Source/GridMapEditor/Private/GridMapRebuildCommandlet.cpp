@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GridMapRebuildCommandlet.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GridMapCellIndex.h"
+#include "GridMapEditor.h"
+#include "GridMapInfo.h"
+#include "GridMapRebuild.h"
+#include "GridMapStaticMeshActor.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "TileSet.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+UGridMapRebuildCommandlet::UGridMapRebuildCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGridMapRebuildCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> SwitchParams;
+	ParseCommandLine(*Params, Tokens, Switches, SwitchParams);
+
+	if (Tokens.Num() == 0)
+	{
+		UE_LOG(LogGridMapEditor, Error, TEXT("No maps given. Usage: -run=GridMapRebuild <MapPackage> [<MapPackage>...] [-TileSize=<Size>] [-TileHeight=<Height>] [-NoSave]"));
+		return 1;
+	}
+
+	int32 TileSizeOverride = 0;
+	if (const FString* TileSize = SwitchParams.Find(TEXT("TileSize")))
+	{
+		TileSizeOverride = FCString::Atoi(**TileSize);
+	}
+	int32 TileHeightOverride = 0;
+	if (const FString* TileHeight = SwitchParams.Find(TEXT("TileHeight")))
+	{
+		TileHeightOverride = FCString::Atoi(**TileHeight);
+	}
+	const bool bSave = !Switches.Contains(TEXT("NoSave"));
+
+	int32 NumFailed = 0;
+	for (const FString& MapName : Tokens)
+	{
+		if (!RebuildMap(MapName, TileSizeOverride, TileHeightOverride, bSave))
+		{
+			++NumFailed;
+		}
+	}
+
+	UE_LOG(LogGridMapEditor, Display, TEXT("Rebuilt %d of %d maps"), Tokens.Num() - NumFailed, Tokens.Num());
+	return NumFailed > 0 ? 1 : 0;
+}
+
+bool UGridMapRebuildCommandlet::RebuildMap(const FString& MapName, int32 TileSizeOverride, int32 TileHeightOverride, bool bSave)
+{
+	FString PackageName;
+	if (!FPackageName::TryConvertFilenameToLongPackageName(MapName, PackageName))
+	{
+		PackageName = MapName;
+	}
+
+	const double LoadStartTime = FPlatformTime::Seconds();
+
+	UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (World == nullptr)
+	{
+		UE_LOG(LogGridMapEditor, Error, TEXT("%s: couldn't load the map"), *PackageName);
+		return false;
+	}
+
+	World->WorldType = EWorldType::Editor;
+	World->AddToRoot();
+	if (!World->bIsWorldInitialized)
+	{
+		UWorld::InitializationValues InitValues;
+		InitValues.RequiresHitProxies(false)
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false);
+		World->InitWorld(InitValues);
+	}
+
+	const double LoadTime = FPlatformTime::Seconds() - LoadStartTime;
+
+	// the tile size lives on the tile sets, go with whatever the first tile uses
+	int32 TileSize = TileSizeOverride;
+	int32 TileHeight = TileHeightOverride;
+	for (TActorIterator<AGridMapStaticMeshActor> It(World); It && (TileSize <= 0 || TileHeight <= 0); ++It)
+	{
+		if (IsValid(*It) && It->TileSet)
+		{
+			TileSize = TileSize > 0 ? TileSize : It->TileSet->TileSize;
+			TileHeight = TileHeight > 0 ? TileHeight : It->TileSet->TileHeight;
+		}
+	}
+
+	const AGridMapInfo* GridMapInfo = AGridMapInfo::GetForLevel(World->PersistentLevel, false);
+	const int32 Seed = GridMapInfo ? GridMapInfo->Seed : 0;
+
+	const double GatherStartTime = FPlatformTime::Seconds();
+	FGridMapCellIndex CellIndex;
+	CellIndex.Rebuild(World, TileSize, TileHeight);
+
+	FGridMapRebuild Rebuild;
+	Rebuild.Gather(World, CellIndex);
+
+	const double ComputeStartTime = FPlatformTime::Seconds();
+	Rebuild.Compute(Seed);
+
+	const double ApplyStartTime = FPlatformTime::Seconds();
+	Rebuild.Apply(false);
+	const double ApplyEndTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogGridMapEditor, Display, TEXT("%s: %d cells visited, %d changed, %d unresolved (tile size %d, height %d, seed %d)"),
+		*PackageName, Rebuild.GetNumTiles(), Rebuild.GetNumChanged(), Rebuild.GetNumUnresolved(), TileSize, TileHeight, Seed);
+	for (const FGridMapUnresolvedMask& UnresolvedMask : Rebuild.GetUnresolvedMasks())
+	{
+		UE_LOG(LogGridMapEditor, Warning, TEXT("%s: %s has no tile list for mask 0x%02X (%d cells)"),
+			*PackageName, *UnresolvedMask.TileSet->GetPathName(), UnresolvedMask.Mask, UnresolvedMask.NumTiles);
+	}
+	UE_LOG(LogGridMapEditor, Display, TEXT("%s: load %.1fms, gather %.1fms, compute %.1fms, apply %.1fms"),
+		*PackageName,
+		LoadTime * 1000.0,
+		(ComputeStartTime - GatherStartTime) * 1000.0,
+		(ApplyStartTime - ComputeStartTime) * 1000.0,
+		(ApplyEndTime - ApplyStartTime) * 1000.0);
+
+	bool bSucceeded = true;
+	if (bSave && Rebuild.GetNumChanged() > 0)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetMapPackageExtension());
+		if (IFileManager::Get().IsReadOnly(*Filename))
+		{
+			UE_LOG(LogGridMapEditor, Error, TEXT("%s: %s is read only, not saving"), *PackageName, *Filename);
+			bSucceeded = false;
+		}
+		else
+		{
+			FSavePackageArgs SaveArgs;
+			SaveArgs.TopLevelFlags = RF_Standalone;
+			bSucceeded = UPackage::SavePackage(Package, World, *Filename, SaveArgs);
+			if (!bSucceeded)
+			{
+				UE_LOG(LogGridMapEditor, Error, TEXT("%s: failed to save"), *PackageName);
+			}
+		}
+	}
+
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(RF_NoFlags);
+
+	return bSucceeded;
+}
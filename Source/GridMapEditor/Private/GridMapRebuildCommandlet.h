@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GridMapRebuildCommandlet.generated.h"
+
+/**
+ * Rebuilds every grid map tile in the given maps without an editor session, and saves the maps that changed.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=GridMapRebuild <MapPackage> [<MapPackage>...] [-TileSize=<Size>] [-TileHeight=<Height>] [-NoSave] -nullrhi
+ */
+UCLASS()
+class UGridMapRebuildCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	// End of UCommandlet interface
+
+private:
+	/** Returns false if the map couldn't be loaded or saved */
+	bool RebuildMap(const FString& MapName, int32 TileSizeOverride, int32 TileHeightOverride, bool bSave);
+};
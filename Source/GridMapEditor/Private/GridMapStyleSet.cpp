@@ -28,5 +28,8 @@ FGridMapStyleSet::FGridMapStyleSet(const FString& PluginContentDir)
 
 	Set("GridMapEditCommands.PaintTiles", new FSlateImageBrush(ContentGridMapDir + TEXT("Icons/UIIcons/paint_40.png"), Icon20x20));
 	Set("GridMapEditCommands.SelectTiles", new FSlateImageBrush(ContentGridMapDir + TEXT("Icons/UIIcons/icon_GridMap_Select_40x.png"), Icon20x20));
+	Set("GridMapEditCommands.RectangleTiles", new FSlateImageBrush(RootToContentDir(TEXT("Icons/GeneralTools/Marquee_40x.png")), Icon20x20));
+	Set("GridMapEditCommands.LineTiles", new FSlateImageBrush(RootToContentDir(TEXT("Icons/GeneralTools/Paint_40x.png")), Icon20x20));
+	Set("GridMapEditCommands.FillTiles", new FSlateImageBrush(RootToContentDir(TEXT("Icons/GeneralTools/PaintBucket_40x.png")), Icon20x20));
 	Set("GridMapEditCommands.TileSettings", new FSlateImageBrush(ContentGridMapDir + TEXT("Icons/UIIcons/icon_GridMap_Settings_40x.png"), Icon20x20));
 }
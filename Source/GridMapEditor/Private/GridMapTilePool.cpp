@@ -0,0 +1,116 @@
+#include "GridMapTilePool.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GridMapStaticMeshActor.h"
+
+FGridMapTilePool& FGridMapTilePool::Get()
+{
+	static FGridMapTilePool Pool;
+	return Pool;
+}
+
+void FGridMapTilePool::Release(AGridMapStaticMeshActor* Tile)
+{
+	if (!IsValid(Tile) || IsPooled(Tile))
+		return;
+
+	if (Tiles.Num() >= MaxPooledTiles)
+	{
+		Tile->GetWorld()->DestroyActor(Tile);
+		return;
+	}
+
+	Tile->TileSet = nullptr;
+	Tile->GetStaticMeshComponent()->SetStaticMesh(nullptr);
+	Tile->SetActorEnableCollision(false);
+	Park(Tile);
+
+	GEngine->BroadcastLevelActorListChanged();
+}
+
+AGridMapStaticMeshActor* FGridMapTilePool::Acquire(UWorld* World, bool bHideFromSceneOutliner)
+{
+	while (Tiles.Num() > 0)
+	{
+		AGridMapStaticMeshActor* Tile = Tiles.Pop(false).Get();
+		if (Tile)
+		{
+			PooledTiles.Remove(Tile);
+		}
+
+		if (!IsValid(Tile))
+			continue;
+
+		// left over from another map, which takes it down with it
+		if (Tile->GetWorld() != World)
+			continue;
+
+		Tile->SetActorEnableCollision(true);
+		Unpark(Tile, bHideFromSceneOutliner);
+		Tile->MarkPackageDirty();
+
+		GEngine->BroadcastLevelActorListChanged();
+		return Tile;
+	}
+
+	return nullptr;
+}
+
+void FGridMapTilePool::Reconcile()
+{
+	TMap<const ULevel*, TSet<const AActor*>> LevelActors;
+	for (int32 TileIndex = Tiles.Num() - 1; TileIndex >= 0; --TileIndex)
+	{
+		AGridMapStaticMeshActor* Tile = Tiles[TileIndex].Get();
+		const ULevel* Level = IsValid(Tile) ? Tile->GetLevel() : nullptr;
+
+		bool bInLevel = false;
+		if (Level)
+		{
+			TSet<const AActor*>* Actors = LevelActors.Find(Level);
+			if (Actors == nullptr)
+			{
+				Actors = &LevelActors.Add(Level, TSet<const AActor*>(Level->Actors));
+			}
+			bInLevel = Actors->Contains(Tile);
+		}
+
+		if (bInLevel)
+			continue;
+
+		if (Tile)
+		{
+			PooledTiles.Remove(Tile);
+
+			// redo can put it back in the level, as an ordinary tile
+			Unpark(Tile, false);
+		}
+		Tiles.RemoveAtSwap(TileIndex, 1, false);
+	}
+}
+
+bool FGridMapTilePool::IsPooled(const AGridMapStaticMeshActor* Tile) const
+{
+	return Tile && PooledTiles.Contains(Tile);
+}
+
+void FGridMapTilePool::Park(AGridMapStaticMeshActor* Tile)
+{
+	Tile->SetIsTemporarilyHiddenInEditor(true);
+	FSetActorHiddenInSceneOutliner(Tile, true);
+
+	// pooled tiles are never saved with the level
+	Tile->SetFlags(RF_Transient);
+
+	Tiles.Add(Tile);
+	PooledTiles.Add(Tile);
+}
+
+void FGridMapTilePool::Unpark(AGridMapStaticMeshActor* Tile, bool bHideFromSceneOutliner)
+{
+	Tile->ClearFlags(RF_Transient);
+	Tile->SetIsTemporarilyHiddenInEditor(false);
+	FSetActorHiddenInSceneOutliner(Tile, bHideFromSceneOutliner);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class AGridMapStaticMeshActor;
+class UWorld;
+
+/**
+ * Erased tile actors are parked here, hidden and transient, so later spawns can reuse them
+ * rather than going through SpawnActor again.
+ */
+class FGridMapTilePool
+{
+public:
+	/** Anything erased past this is destroyed as usual */
+	static constexpr int32 MaxPooledTiles = 4096;
+
+	/** The editor's pool, pooled tiles outlive the editor mode so undo can hand them back out */
+	static FGridMapTilePool& Get();
+
+	/**
+	 * Hides the tile and keeps it around for reuse, or destroys it if the pool is full.
+	 * Nothing is recorded, undo brings back the grid data and the view is synced from that.
+	 */
+	void Release(AGridMapStaticMeshActor* Tile);
+
+	/** A pooled tile from the world, made visible again, or null if there aren't any */
+	AGridMapStaticMeshActor* Acquire(UWorld* World, bool bHideFromSceneOutliner);
+
+	/**
+	 * Undo and redo can take a pooled tile out of its level, ie. when the edit that spawned
+	 * it is undone. Drops those from the pool, no other tiles are touched.
+	 */
+	void Reconcile();
+
+	int32 Num() const { return Tiles.Num(); }
+
+	/** True for tiles sitting in the pool, which aren't part of the map */
+	bool IsPooled(const AGridMapStaticMeshActor* Tile) const;
+
+private:
+	/** Parks the tile without recording anything, pooled tiles aren't part of the level's undo history */
+	void Park(AGridMapStaticMeshActor* Tile);
+	void Unpark(AGridMapStaticMeshActor* Tile, bool bHideFromSceneOutliner);
+
+	TArray<TWeakObjectPtr<AGridMapStaticMeshActor>> Tiles;
+	TSet<TObjectKey<AGridMapStaticMeshActor>> PooledTiles;
+};
@@ -0,0 +1,115 @@
+#include "GridMapTimeSlicedRebuild.h"
+#include "Engine/World.h"
+#include "GridMapCellIndex.h"
+#include "GridMapData.h"
+#include "GridMapEditor.h"
+#include "GridMapRebuild.h"
+#include "GridMapStats.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+DECLARE_CYCLE_STAT(TEXT("Rebuild Time Slice"), STAT_GridMap_RebuildTimeSlice, STATGROUP_GridMap);
+
+void FGridMapTimeSlicedRebuild::Start(UWorld* InWorld, const FGridMapCellIndex& Index, int32 InSeed)
+{
+	check(IsInGameThread());
+
+	Cancel();
+
+	const UGridMapData* Data = Index.GetData();
+	if (InWorld == nullptr || Data == nullptr)
+		return;
+
+	World = InWorld;
+	Seed = InSeed;
+	NumTiles = 0;
+	NumChanged = 0;
+	NumUnresolved = 0;
+	StartTime = FPlatformTime::Seconds();
+
+	ChunkCoords.Reserve(Data->GetChunks().Num());
+	for (const FGridMapDataChunk& Chunk : Data->GetChunks())
+	{
+		ChunkCoords.Add(Chunk.ChunkCoord);
+	}
+
+	// the chunks' order in the data shuffles around as chunks are added and removed
+	ChunkCoords.Sort([](const FIntVector& A, const FIntVector& B)
+	{
+		if (A.Z != B.Z)
+			return A.Z < B.Z;
+		if (A.Y != B.Y)
+			return A.Y < B.Y;
+		return A.X < B.X;
+	});
+}
+
+bool FGridMapTimeSlicedRebuild::Tick(const FGridMapCellIndex& Index, float BudgetMs, bool bDebugDrawTiles, FGridMapMeshStreamer* MeshStreamer)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GridMap_RebuildTimeSlice);
+	TRACE_CPUPROFILER_EVENT_SCOPE(GridMap_RebuildTimeSlice);
+
+	check(IsInGameThread());
+
+	if (!IsRunning())
+		return false;
+
+	// the map changed underneath us, there's nothing left to rebuild
+	UWorld* RebuildWorld = World.Get();
+	if (RebuildWorld == nullptr || !Index.IsValidFor(RebuildWorld, Index.GetCellSize(), Index.GetCellHeight()) || Index.GetData() == nullptr)
+	{
+		Cancel();
+		return false;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + BudgetMs / 1000.0;
+	const int32 NumChangedBefore = NumChanged;
+
+	do
+	{
+		FGridMapRebuild Rebuild;
+		Rebuild.GatherChunk(RebuildWorld, Index, ChunkCoords[NextChunk++], MeshStreamer);
+		Rebuild.Compute(Seed);
+		Rebuild.Apply(bDebugDrawTiles, MeshStreamer);
+
+		NumTiles += Rebuild.GetNumTiles();
+		NumChanged += Rebuild.GetNumChanged();
+		NumUnresolved += Rebuild.GetNumUnresolved();
+	}
+	while (IsRunning() && FPlatformTime::Seconds() < EndTime);
+
+	if (!IsRunning())
+	{
+		Finish();
+	}
+
+	return NumChanged != NumChangedBefore;
+}
+
+void FGridMapTimeSlicedRebuild::Cancel()
+{
+	if (IsRunning())
+	{
+		UE_LOG(LogGridMapEditor, Display, TEXT("Rebuild cancelled after %d of %d chunks"), NextChunk, ChunkCoords.Num());
+	}
+
+	World.Reset();
+	ChunkCoords.Reset();
+	NextChunk = 0;
+}
+
+float FGridMapTimeSlicedRebuild::GetProgress() const
+{
+	return ChunkCoords.Num() > 0 ? (float)NextChunk / ChunkCoords.Num() : 1.f;
+}
+
+void FGridMapTimeSlicedRebuild::Finish()
+{
+	UE_LOG(LogGridMapEditor, Display, TEXT("Rebuilt %d tiles in %d chunks over %.2f s, %d changed, %d unresolved"),
+		NumTiles, ChunkCoords.Num(), FPlatformTime::Seconds() - StartTime, NumChanged, NumUnresolved);
+	FGridMapRebuild::ReportUnresolved(NumUnresolved);
+
+	World.Reset();
+	ChunkCoords.Reset();
+	NextChunk = 0;
+}
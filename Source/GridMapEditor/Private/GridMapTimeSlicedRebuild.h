@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+class FGridMapCellIndex;
+class FGridMapMeshStreamer;
+class UWorld;
+
+/**
+ * Rebuilds every tile in a world a chunk of grid data at a time, spread over
+ * as many ticks as it takes to stay within a per frame budget. Chunks are
+ * committed in a fixed order, so the end result is the same as a full rebuild
+ * no matter how the work ended up being sliced. Nothing is recorded for undo,
+ * it only changes the tiles' meshes and the resolves kept in the grid data.
+ */
+class FGridMapTimeSlicedRebuild
+{
+public:
+	/** Queues up every chunk of the world's grid data, replacing any rebuild that's still running */
+	void Start(UWorld* InWorld, const FGridMapCellIndex& Index, int32 InSeed);
+
+	/**
+	 * Rebuilds chunks until the budget runs out, at least one per call so it always
+	 * gets somewhere. Returns true if any tiles were changed.
+	 */
+	bool Tick(const FGridMapCellIndex& Index, float BudgetMs, bool bDebugDrawTiles, FGridMapMeshStreamer* MeshStreamer);
+
+	/** Stops the rebuild, chunks that were already rebuilt stay that way */
+	void Cancel();
+
+	bool IsRunning() const { return NextChunk < ChunkCoords.Num(); }
+
+	/** 0-1, by number of chunks rebuilt */
+	float GetProgress() const;
+
+	int32 GetNumChanged() const { return NumChanged; }
+	int32 GetNumUnresolved() const { return NumUnresolved; }
+
+private:
+	void Finish();
+
+	TWeakObjectPtr<UWorld> World;
+	int32 Seed = 0;
+
+	/** Sorted by Z, then Y, then X */
+	TArray<FIntVector> ChunkCoords;
+	int32 NextChunk = 0;
+
+	int32 NumTiles = 0;
+	int32 NumChanged = 0;
+	int32 NumUnresolved = 0;
+	double StartTime = 0.0;
+};
@@ -0,0 +1,270 @@
+#include "GridMapViewSync.h"
+#include "Editor.h"
+#include "EditorModeManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GridMapCellChange.h"
+#include "GridMapChunkActor.h"
+#include "GridMapData.h"
+#include "GridMapEditorMode.h"
+#include "GridMapInfo.h"
+#include "GridMapRebuild.h"
+#include "GridMapStaticMeshActor.h"
+#include "GridMapTilePool.h"
+#include "TileSet.h"
+
+FGridMapViewSync::FGridMapViewSync()
+{
+	GEditor->RegisterForUndo(this);
+	OnLevelActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FGridMapViewSync::OnLevelActorAdded);
+	OnLevelActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FGridMapViewSync::OnLevelActorDeleted);
+	OnActorMovedHandle = GEngine->OnActorMoved().AddRaw(this, &FGridMapViewSync::OnActorMoved);
+	OnMapChangedHandle = FEditorDelegates::MapChange.AddRaw(this, &FGridMapViewSync::OnMapChanged);
+	OnLevelAddedToWorldHandle = FWorldDelegates::LevelAddedToWorld.AddRaw(this, &FGridMapViewSync::OnLevelAddedOrRemoved);
+	OnLevelRemovedFromWorldHandle = FWorldDelegates::LevelRemovedFromWorld.AddRaw(this, &FGridMapViewSync::OnLevelAddedOrRemoved);
+	OnEditorModeChangedHandle = GLevelEditorModeTools().OnEditorModeIDChanged().AddRaw(this, &FGridMapViewSync::OnEditorModeChanged);
+	OnCellsRestoredHandle = FGridMapCellChange::OnCellsRestored.AddRaw(this, &FGridMapViewSync::OnCellsRestored);
+}
+
+FGridMapViewSync::~FGridMapViewSync()
+{
+	if (GEditor)
+	{
+		GEditor->UnregisterForUndo(this);
+		GLevelEditorModeTools().OnEditorModeIDChanged().Remove(OnEditorModeChangedHandle);
+	}
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().Remove(OnLevelActorAddedHandle);
+		GEngine->OnLevelActorDeleted().Remove(OnLevelActorDeletedHandle);
+		GEngine->OnActorMoved().Remove(OnActorMovedHandle);
+	}
+	FEditorDelegates::MapChange.Remove(OnMapChangedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(OnLevelAddedToWorldHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(OnLevelRemovedFromWorldHandle);
+	FGridMapCellChange::OnCellsRestored.Remove(OnCellsRestoredHandle);
+}
+
+void FGridMapViewSync::RecordTileMoved(FGridMapCellIndex& Index, AGridMapStaticMeshActor* Tile)
+{
+	FIntVector OldCell;
+	const bool bWasIndexed = Index.FindCell(Tile, OldCell);
+	Index.Add(Tile);
+
+	// pooled tiles and ones that are still being spawned don't have a tile set yet, they aren't part of the grid
+	UGridMapData* Data = Index.GetData();
+	FIntVector NewCell;
+	if (Data == nullptr || Tile->TileSet == nullptr || !Index.FindCell(Tile, NewCell))
+		return;
+
+	if (bWasIndexed && OldCell != NewCell)
+	{
+		FGridMapCellChange::SetTileSet(Data, OldCell, nullptr);
+	}
+	FGridMapCellChange::SetTileSet(Data, NewCell, Tile->TileSet);
+}
+
+void FGridMapViewSync::RecordTileDeleted(FGridMapCellIndex& Index, AGridMapStaticMeshActor* Tile)
+{
+	// tiles the editor destroys itself are taken out of the index first, so they never get here
+	FIntVector Cell;
+	const bool bWasIndexed = Index.FindCell(Tile, Cell);
+	Index.Remove(Tile);
+
+	if (bWasIndexed && Tile->TileSet)
+	{
+		FGridMapCellChange::SetTileSet(Index.GetData(), Cell, nullptr);
+	}
+}
+
+void FGridMapViewSync::PostUndo(bool bSuccess)
+{
+	// undo can resurrect or remove any number of tiles
+	CellIndex.Invalidate();
+	if (!IsModeActive())
+	{
+		FGridMapTilePool::Get().Reconcile();
+		SyncRestoredCells();
+	}
+}
+
+void FGridMapViewSync::PostRedo(bool bSuccess)
+{
+	CellIndex.Invalidate();
+	if (!IsModeActive())
+	{
+		FGridMapTilePool::Get().Reconcile();
+		SyncRestoredCells();
+	}
+}
+
+void FGridMapViewSync::OnCellsRestored(UGridMapData* GridMapData, const TArray<FIntVector>& Cells)
+{
+	// the mode syncs its own
+	if (IsModeActive())
+		return;
+
+	TSet<FIntVector>& DataCells = RestoredCells.FindOrAdd(GridMapData);
+	DataCells.Append(Cells);
+}
+
+void FGridMapViewSync::SyncRestoredCells()
+{
+	// only the level being edited has a view to sync, other levels' tiles are synced when they're next edited
+	UWorld* World = GEditor->GetEditorWorldContext().World();
+	AGridMapInfo* GridMapInfo = World ? AGridMapInfo::GetForLevel(World->PersistentLevel, false) : nullptr;
+	UGridMapData* GridMapData = GridMapInfo ? GridMapInfo->Data.Get() : nullptr;
+
+	TSet<FIntVector> Cells;
+	if (TSet<FIntVector>* DataCells = GridMapData ? RestoredCells.Find(GridMapData) : nullptr)
+	{
+		Cells = MoveTemp(*DataCells);
+	}
+	RestoredCells.Reset();
+
+	if (Cells.Num() == 0)
+		return;
+
+	// without the mode the cell size comes from the tile sets, every one in the level shares it
+	const UGridMapTileSet* AnyTileSet = nullptr;
+	for (int32 TileSetId = 1; TileSetId <= GridMapData->GetNumTileSets() && AnyTileSet == nullptr; ++TileSetId)
+	{
+		AnyTileSet = GridMapData->GetTileSetById(TileSetId);
+	}
+	if (AnyTileSet == nullptr)
+		return;
+
+	if (!CellIndex.IsValidFor(World, AnyTileSet->TileSize, AnyTileSet->TileHeight))
+	{
+		CellIndex.Rebuild(World, AnyTileSet->TileSize, AnyTileSet->TileHeight, &FGridMapTilePool::Get());
+	}
+
+	FGridMapTilePool& TilePool = FGridMapTilePool::Get();
+	for (const FIntVector& Cell : Cells)
+	{
+		UGridMapTileSet* TileSet = CellIndex.GetTileSet(Cell);
+
+		// undo already put the chunk's instances back, all that can be out of step is the tile set
+		if (AGridMapChunkActor* Chunk = CellIndex.FindChunk(Cell))
+		{
+			if (TileSet == nullptr)
+			{
+				Chunk->RemoveTile(Cell);
+			}
+			else if (Chunk->FindTile(Cell)->TileSet != TileSet)
+			{
+				Chunk->SetTile(Cell, TileSet, Chunk->GetTileMesh(Cell), Chunk->GetTileRotation(Cell));
+			}
+			continue;
+		}
+
+		AGridMapStaticMeshActor* Tile = CellIndex.Find(Cell);
+		if (Tile && TileSet == nullptr)
+		{
+			CellIndex.Remove(Tile);
+			TilePool.Release(Tile);
+			continue;
+		}
+
+		if (Tile == nullptr && TileSet)
+		{
+			// reusing a pooled tile leaves the level's actor list alone, spawning outside a transaction is the last resort
+			const FVector Location = CellIndex.CellToLocation(Cell);
+			Tile = TilePool.Acquire(World, false);
+			if (Tile)
+			{
+				Tile->SetActorLocation(Location);
+			}
+			else
+			{
+				Tile = World->SpawnActor<AGridMapStaticMeshActor>(Location, FRotator::ZeroRotator);
+			}
+		}
+
+		if (Tile && Tile->TileSet != TileSet)
+		{
+			Tile->TileSet = TileSet;
+			CellIndex.Add(Tile);
+		}
+	}
+
+	// nothing ticks a streamer without the mode, the meshes are loaded right away
+	FGridMapRebuild Rebuild;
+	Rebuild.GatherCells(World, CellIndex, Cells, nullptr, true);
+	Rebuild.Compute(GridMapInfo->Seed);
+	Rebuild.Apply(false);
+	FGridMapRebuild::ReportUnresolved(Rebuild.GetNumUnresolved());
+}
+
+bool FGridMapViewSync::IsModeActive() const
+{
+	return GLevelEditorModeTools().IsModeActive(FGridMapEditorMode::EM_GridMapEditorModeId);
+}
+
+void FGridMapViewSync::OnLevelActorAdded(AActor* InActor)
+{
+	AGridMapStaticMeshActor* Tile = Cast<AGridMapStaticMeshActor>(InActor);
+	if (FGridMapCellIndex* Index = GetCellIndex(Tile))
+	{
+		RecordTileMoved(*Index, Tile);
+	}
+}
+
+void FGridMapViewSync::OnLevelActorDeleted(AActor* InActor)
+{
+	AGridMapStaticMeshActor* Tile = Cast<AGridMapStaticMeshActor>(InActor);
+	if (FGridMapCellIndex* Index = GetCellIndex(Tile))
+	{
+		RecordTileDeleted(*Index, Tile);
+	}
+}
+
+void FGridMapViewSync::OnActorMoved(AActor* InActor)
+{
+	AGridMapStaticMeshActor* Tile = Cast<AGridMapStaticMeshActor>(InActor);
+	if (FGridMapCellIndex* Index = GetCellIndex(Tile))
+	{
+		RecordTileMoved(*Index, Tile);
+	}
+}
+
+void FGridMapViewSync::OnMapChanged(uint32 MapChangeFlags)
+{
+	CellIndex.Invalidate();
+}
+
+void FGridMapViewSync::OnLevelAddedOrRemoved(ULevel* InLevel, UWorld* InWorld)
+{
+	CellIndex.Invalidate();
+}
+
+void FGridMapViewSync::OnEditorModeChanged(const FEditorModeID& ModeId, bool bIsEnteringMode)
+{
+	// the mode moves tiles in and out of its pool without telling anyone
+	if (ModeId == FGridMapEditorMode::EM_GridMapEditorModeId)
+	{
+		CellIndex.Invalidate();
+	}
+}
+
+FGridMapCellIndex* FGridMapViewSync::GetCellIndex(const AGridMapStaticMeshActor* Tile)
+{
+	if (Tile == nullptr || Tile->GetWorld() != GEditor->GetEditorWorldContext().World())
+		return nullptr;
+
+	if (IsModeActive())
+		return nullptr;
+
+	// without the mode there's no active tile set, the tile's own says how big the cells are
+	if (Tile->TileSet == nullptr)
+		return CellIndex.IsValidFor(Tile->GetWorld(), CellIndex.GetCellSize(), CellIndex.GetCellHeight()) ? &CellIndex : nullptr;
+
+	const int32 CellSize = Tile->TileSet->TileSize;
+	const int32 CellHeight = Tile->TileSet->TileHeight;
+	if (!CellIndex.IsValidFor(Tile->GetWorld(), CellSize, CellHeight))
+	{
+		CellIndex.Rebuild(Tile->GetWorld(), CellSize, CellHeight, &FGridMapTilePool::Get());
+	}
+
+	return &CellIndex;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorUndoClient.h"
+#include "Tools/Modes.h"
+#include "GridMapCellIndex.h"
+
+class AActor;
+class AGridMapStaticMeshActor;
+class UGridMapData;
+class ULevel;
+class UWorld;
+
+/**
+ * Keeps the level's grid data in step with tile actors that are added, moved or deleted
+ * by hand while the editor mode isn't active, and brings the tiles back in line with the
+ * data after undo or redo restored some cells. The mode does the same itself while it's active.
+ */
+class FGridMapViewSync : public FEditorUndoClient
+{
+public:
+	FGridMapViewSync();
+	virtual ~FGridMapViewSync();
+
+	/** Puts the tile's tile set in the cell it's in now, and clears the one it was indexed in before */
+	static void RecordTileMoved(FGridMapCellIndex& Index, AGridMapStaticMeshActor* Tile);
+
+	/** Clears the tile's cell, as long as it was the tile in it */
+	static void RecordTileDeleted(FGridMapCellIndex& Index, AGridMapStaticMeshActor* Tile);
+
+	// FEditorUndoClient interface
+	virtual void PostUndo(bool bSuccess) override;
+	virtual void PostRedo(bool bSuccess) override;
+	// End of FEditorUndoClient interface
+
+private:
+	void OnLevelActorAdded(AActor* InActor);
+	void OnLevelActorDeleted(AActor* InActor);
+	void OnActorMoved(AActor* InActor);
+	void OnMapChanged(uint32 MapChangeFlags);
+	void OnLevelAddedOrRemoved(ULevel* InLevel, UWorld* InWorld);
+	void OnEditorModeChanged(const FEditorModeID& ModeId, bool bIsEnteringMode);
+	void OnCellsRestored(UGridMapData* GridMapData, const TArray<FIntVector>& Cells);
+
+	/** Spawns, retiles or releases the restored cells' tiles to match the grid data, then resolves them */
+	void SyncRestoredCells();
+	bool IsModeActive() const;
+
+	/** The index of the level being edited, or null if the tile isn't in it or the editor mode is looking after it */
+	FGridMapCellIndex* GetCellIndex(const AGridMapStaticMeshActor* Tile);
+
+	FGridMapCellIndex CellIndex;
+
+	/** Cells undo or redo put back in each level's grid data, their tiles are synced once it's done */
+	TMap<TWeakObjectPtr<UGridMapData>, TSet<FIntVector>> RestoredCells;
+
+	FDelegateHandle OnLevelActorAddedHandle;
+	FDelegateHandle OnLevelActorDeletedHandle;
+	FDelegateHandle OnActorMovedHandle;
+	FDelegateHandle OnMapChangedHandle;
+	FDelegateHandle OnLevelAddedToWorldHandle;
+	FDelegateHandle OnLevelRemovedFromWorldHandle;
+	FDelegateHandle OnEditorModeChangedHandle;
+	FDelegateHandle OnCellsRestoredHandle;
+};
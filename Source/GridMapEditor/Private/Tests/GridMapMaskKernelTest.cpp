@@ -0,0 +1,112 @@
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+#include "GridMapData.h"
+#include "GridMapMaskKernel.h"
+#include "GridMapRebuild.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "TileSet.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridMapMaskKernelTest, "GridMap.Rebuild.MaskKernel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/** Fills a random grid around the origin and checks the mask kernel against working each mask out one cell at a time */
+bool FGridMapMaskKernelTest::RunTest(const FString& Parameters)
+{
+	static const TCHAR* TileSetPaths[] = {
+		TEXT("/GridMapEditor/TS_Floor_Test.TS_Floor_Test"),
+		TEXT("/GridMapEditor/TS_Wall_Test.TS_Wall_Test"),
+	};
+
+	// each test tile set as it is and with bMatchesEmpty the other way around
+	TArray<UGridMapTileSet*> TileSets;
+	for (const TCHAR* TileSetPath : TileSetPaths)
+	{
+		UGridMapTileSet* TileSet = LoadObject<UGridMapTileSet>(nullptr, TileSetPath);
+		if (!TestNotNull(FString::Printf(TEXT("%s loads"), TileSetPath), TileSet))
+			return false;
+
+		UGridMapTileSet* FlippedTileSet = DuplicateObject<UGridMapTileSet>(TileSet, GetTransientPackage());
+		FlippedTileSet->bMatchesEmpty = !TileSet->bMatchesEmpty;
+
+		TileSets.Add(TileSet);
+		TileSets.Add(FlippedTileSet);
+	}
+
+	// centred on the origin, so there are chunks on both sides of zero on each axis
+	static constexpr int32 Side = 256;
+	static constexpr int32 Offset = -Side / 2;
+
+	// a fixed seed, so a mismatch can be reproduced
+	UGridMapData* Data = NewObject<UGridMapData>(GetTransientPackage());
+	FRandomStream Random(Side);
+	for (int32 Y = 0; Y < Side; ++Y)
+	{
+		for (int32 X = 0; X < Side; ++X)
+		{
+			const int32 Choice = Random.RandRange(0, TileSets.Num());
+			Data->SetTileSet(FIntVector(X + Offset, Y + Offset, 0), Choice < TileSets.Num() ? TileSets[Choice] : nullptr);
+		}
+	}
+
+	// the same way the rebuild runs it
+	const TArray<FGridMapDataChunk>& Chunks = Data->GetChunks();
+	TArray<uint8> ChunkMasks;
+	ChunkMasks.SetNumUninitialized(Chunks.Num() * UGridMapData::CellsPerChunk);
+
+	double StartTime = FPlatformTime::Seconds();
+	const FGridMapMaskKernel Kernel(*Data);
+	ParallelFor(Chunks.Num(), [&Kernel, &Chunks, &ChunkMasks](int32 ChunkIndex)
+	{
+		Kernel.ComputeChunk(Chunks[ChunkIndex], &ChunkMasks[ChunkIndex * UGridMapData::CellsPerChunk]);
+	});
+	const double KernelMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	auto GetTileSetAt = [Data](const FIntVector& Cell) -> const UGridMapTileSet*
+	{
+		return Data->GetTileSet(Cell);
+	};
+
+	int32 NumCells = 0;
+	int32 NumMismatches = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		for (int32 CellIndex = 0; CellIndex < UGridMapData::CellsPerChunk; ++CellIndex)
+		{
+			const FIntVector Cell = UGridMapData::ChunkIndexToCell(Chunks[ChunkIndex].ChunkCoord, CellIndex);
+			const UGridMapTileSet* TileSet = Data->GetTileSet(Cell);
+
+			// empty cells don't have a mask
+			const uint8 Expected = TileSet ? (uint8)FGridMapRebuild::GetAdjacencyBitmask(TileSet, Cell, GetTileSetAt) : 0;
+			const uint8 Actual = ChunkMasks[ChunkIndex * UGridMapData::CellsPerChunk + CellIndex];
+			NumCells += TileSet ? 1 : 0;
+
+			if (Actual != Expected && NumMismatches++ < 10)
+			{
+				AddError(FString::Printf(TEXT("Mask mismatch at %s (%s): kernel 0x%02X, one cell at a time 0x%02X"),
+					*Cell.ToString(), TileSet ? *TileSet->GetName() : TEXT("empty"), Actual, Expected));
+			}
+		}
+	}
+	const double ScalarMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	TestEqual(TEXT("Mask mismatches"), NumMismatches, 0);
+	AddInfo(FString::Printf(TEXT("%dx%d grid with %d tiles in %d chunks: kernel %.3f ms, one cell at a time %.3f ms"),
+		Side, Side, NumCells, Chunks.Num(), KernelMs, ScalarMs));
+
+	for (UGridMapTileSet* TileSet : TileSets)
+	{
+		if (TileSet->GetOutermost() == GetTransientPackage())
+		{
+			TileSet->MarkAsGarbage();
+		}
+	}
+	Data->MarkAsGarbage();
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,85 @@
+#include "CoreMinimal.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "GridMapBenchmark.h"
+#include "GridMapStaticMeshActor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGridMapOverlapPerfTest, "GridMap.Perf.TileOverlaps", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Times an overlapping actor moving back and forth over a grid of tiles, with the tiles'
+ * overlap events off as they are now and turned back on, the same as GridMap.TileOverlaps
+ */
+bool FGridMapOverlapPerfTest::RunTest(const FString& Parameters)
+{
+	static constexpr int32 Side = 100;
+	static constexpr int32 CellSize = 100;
+	static constexpr int32 NumMoves = 1000;
+
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!TestNotNull(TEXT("Cube mesh loads"), CubeMesh))
+		return false;
+
+	FGridMapBenchmark Benchmark;
+	UWorld* World = Benchmark.GetWorld();
+
+	TArray<AGridMapStaticMeshActor*> Tiles;
+	for (int32 Y = 0; Y < Side; ++Y)
+	{
+		for (int32 X = 0; X < Side; ++X)
+		{
+			AGridMapStaticMeshActor* Tile = World->SpawnActor<AGridMapStaticMeshActor>(FVector(X * CellSize, Y * CellSize, 0.f), FRotator::ZeroRotator);
+			Tile->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+			Tiles.Add(Tile);
+		}
+	}
+
+	// something like a character, overlapping the tiles under it as it goes
+	AStaticMeshActor* Mover = World->SpawnActor<AStaticMeshActor>(FVector::ZeroVector, FRotator::ZeroRotator);
+	UStaticMeshComponent* MoverComponent = Mover->GetStaticMeshComponent();
+	MoverComponent->SetMobility(EComponentMobility::Movable);
+	MoverComponent->SetStaticMesh(CubeMesh);
+	MoverComponent->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+	MoverComponent->SetGenerateOverlapEvents(true);
+	MoverComponent->SetRelativeScale3D(FVector(3.f));
+
+	auto TimeMoves = [&]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Move = 0; Move < NumMoves; ++Move)
+		{
+			// diagonally across the grid and back, a cell at a time
+			const int32 Step = Move % (2 * Side);
+			const int32 Cell = Step < Side ? Step : 2 * Side - 1 - Step;
+			Mover->SetActorLocation(FVector(Cell * CellSize, Cell * CellSize, CellSize * 0.5f));
+		}
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	};
+
+	auto SetTileOverlaps = [&Tiles](bool bGenerateOverlapEvents)
+	{
+		for (AGridMapStaticMeshActor* Tile : Tiles)
+		{
+			Tile->GetStaticMeshComponent()->SetGenerateOverlapEvents(bGenerateOverlapEvents);
+		}
+	};
+
+	TestFalse(TEXT("Tiles don't generate overlap events"), Tiles[0]->GetStaticMeshComponent()->GetGenerateOverlapEvents());
+
+	SetTileOverlaps(false);
+	const double OffMs = TimeMoves();
+
+	SetTileOverlaps(true);
+	const double OnMs = TimeMoves();
+
+	AddInfo(FString::Printf(TEXT("%d moves over %d tiles: %.2f ms with tile overlaps off, %.2f ms with them on"), NumMoves, Tiles.Num(), OffMs, OnMs));
+	TestTrue(TEXT("Moving tiles is cheaper with tile overlaps off"), OffMs < OnMs);
+	return true;
+}
+
+#endif
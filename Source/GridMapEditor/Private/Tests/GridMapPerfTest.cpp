@@ -0,0 +1,86 @@
+#include "CoreMinimal.h"
+#include "GridMapBenchmark.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/DateTime.h"
+#include "Misc/PackageName.h"
+#include "TileSet.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/** Cells in the timed stroke, drawn along the edge of the grid */
+static constexpr int32 GridMapPerfStrokeLength = 64;
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FGridMapPerfTest, "GridMap.Perf", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FGridMapPerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	static const int32 TileCounts[] = { 1000, 10000, 100000 };
+
+	for (const TCHAR* TileSetPath : FGridMapBenchmark::TestTileSets)
+	{
+		for (int32 TileCount : TileCounts)
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("%s.%d"), *FPackageName::ObjectPathToObjectName(TileSetPath), TileCount));
+			OutTestCommands.Add(FString::Printf(TEXT("%s %d"), TileSetPath, TileCount));
+		}
+	}
+}
+
+/** Times rebuild, single paint, erase and stroke on a synthetic grid, and appends the results to Saved/GridMap/Perf.csv */
+bool FGridMapPerfTest::RunTest(const FString& Parameters)
+{
+	FString TileSetPath;
+	FString TileCountString;
+	if (!Parameters.Split(TEXT(" "), &TileSetPath, &TileCountString))
+	{
+		AddError(FString::Printf(TEXT("Bad test parameters '%s'"), *Parameters));
+		return false;
+	}
+
+	UGridMapTileSet* TileSet = LoadObject<UGridMapTileSet>(nullptr, *TileSetPath);
+	if (!TestNotNull(FString::Printf(TEXT("%s loads"), *TileSetPath), TileSet))
+		return false;
+
+	FGridMapBenchmark Benchmark;
+	const int32 SpawnedTiles = Benchmark.SpawnSyntheticGrid(TileSet, FCString::Atoi(*TileCountString));
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt((float)SpawnedTiles));
+	const FString Timestamp = FDateTime::UtcNow().ToIso8601();
+
+	FString Rows;
+	auto Record = [&](const TCHAR* Operation, double StartTime)
+	{
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		AddInfo(FString::Printf(TEXT("%-8s %8d tiles: %10.2f ms"), Operation, SpawnedTiles, ElapsedMs));
+		Rows += FString::Printf(TEXT("%s,%s,%s,%s,%d,%.3f\n"), *Timestamp, FApp::GetBuildVersion(), *TileSet->GetName(), Operation, SpawnedTiles, ElapsedMs);
+	};
+
+	double StartTime = FPlatformTime::Seconds();
+	Benchmark.UpdateAllTiles();
+	Record(TEXT("Rebuild"), StartTime);
+
+	// one tile next to the grid, so it has neighbours to update
+	StartTime = FPlatformTime::Seconds();
+	Benchmark.PressBrush(FIntVector(-1, Side / 2, 0), false);
+	Record(TEXT("Paint"), StartTime);
+
+	StartTime = FPlatformTime::Seconds();
+	Benchmark.PressBrush(FIntVector(Side / 2, Side / 2, 0), true);
+	Record(TEXT("Erase"), StartTime);
+
+	// a drag along the top edge of the grid, committed on release
+	TArray<FIntVector> StrokeCells;
+	for (int32 X = 0; X < GridMapPerfStrokeLength; ++X)
+	{
+		StrokeCells.Add(FIntVector(X, -1, 0));
+	}
+
+	StartTime = FPlatformTime::Seconds();
+	Benchmark.DragBrush(StrokeCells);
+	Record(TEXT("Stroke"), StartTime);
+
+	FGridMapBenchmark::WritePerfResults(Rows);
+	return true;
+}
+
+#endif
@@ -1,12 +1,15 @@
 #include "Widgets/GridMapEditorSettingsWidget.h"
 #include "GridMapEditorMode.h"
+#include "EditorStyleSet.h"
 #include "GridMapEditorUISettings.h"
 #include "GridMapStyleSet.h"
 #include "Widgets/Input/SButton.h"
 #include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SNumericEntryBox.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SHeader.h"
 #include "Widgets/Layout/SWrapBox.h"
+#include "Widgets/Notifications/SProgressBar.h"
 #include "Widgets/Text/STextBlock.h"
 
 #define LOCTEXT_NAMESPACE "GridMapEditor"
@@ -45,10 +48,213 @@ void SGridMapEditorSettingsWidget::Construct(const FArguments& InArgs, FGridMapE
 				.HAlign(HAlign_Center)
 				.VAlign(VAlign_Center)
 				.OnClicked(this, &SGridMapEditorSettingsWidget::OnRebuildAllTiles)
+				.IsEnabled(this, &SGridMapEditorSettingsWidget::IsEnabled_RebuildAllTiles)
 				.Text(LOCTEXT("RebuildAllTiles", "Build All Tiles"))
 				.ToolTipText(LOCTEXT("Rebuild All Tiles", "Recalculates adjacency for all tiles and select the correct mesh"))
 			]
 		]
+		// Build all progress
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(FGridMapStyleSet::StandardPadding)
+		[
+			SNew(SHorizontalBox)
+			.Visibility(this, &SGridMapEditorSettingsWidget::GetVisibility_RebuildProgress)
+
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			.VAlign(VAlign_Center)
+			.Padding(0.f, 0.f, 3.f, 0.f)
+			[
+				SNew(SProgressBar)
+				.Percent(this, &SGridMapEditorSettingsWidget::GetRebuildProgress)
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.VAlign(VAlign_Center)
+				.OnClicked(this, &SGridMapEditorSettingsWidget::OnCancelRebuild)
+				.Text(LOCTEXT("CancelRebuild", "Cancel"))
+				.ToolTipText(LOCTEXT("CancelRebuild_ToolTip", "Stops the build, the tiles that were already built keep their new meshes"))
+			]
+		]
+		// Time sliced builds
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(FGridMapStyleSet::StandardPadding)
+		[
+			SNew(SHorizontalBox)
+
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SCheckBox)
+				.OnCheckStateChanged(this, &SGridMapEditorSettingsWidget::OnCheckStateChanged_TimeSliceRebuilds)
+				.IsChecked(this, &SGridMapEditorSettingsWidget::GetCheckState_TimeSliceRebuilds)
+				.ToolTipText(LOCTEXT("TimeSliceRebuilds_ToolTip", "Builds the tiles a chunk at a time over several frames, so the editor stays responsive on large maps"))
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("TimeSliceRebuilds", "Build In Background"))
+					.Font(FGridMapStyleSet::StandardFont)
+				]
+			]
+
+			+ SHorizontalBox::Slot()
+			.Padding(FGridMapStyleSet::StandardRightPadding)
+			.FillWidth(1.0f)
+			.MaxWidth(100.f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SNumericEntryBox<float>)
+				.Font(FGridMapStyleSet::StandardFont)
+				.AllowSpin(false)
+				.MinDesiredValueWidth(50.0f)
+				.ToolTipText(LOCTEXT("RebuildBudgetMs_ToolTip", "How many milliseconds each frame may spend building tiles in the background"))
+				.Value(this, &SGridMapEditorSettingsWidget::GetRebuildBudgetMs)
+				.OnValueCommitted(this, &SGridMapEditorSettingsWidget::OnRebuildBudgetMsCommitted)
+			]
+		]
+		// Instancing
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(FGridMapStyleSet::StandardPadding)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.Padding(0.f, 0.f, 3.f, 0.f)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.VAlign(VAlign_Center)
+				.OnClicked(this, &SGridMapEditorSettingsWidget::OnConvertTilesToInstances)
+				.Text(LOCTEXT("ConvertTilesToInstances", "Convert To Instances"))
+				.ToolTipText(LOCTEXT("ConvertTilesToInstances_ToolTip", "Replaces every tile actor with instances in chunk actors, one instanced component per mesh per chunk"))
+			]
+			+ SHorizontalBox::Slot()
+			.Padding(3.f, 0.f, 0.f, 0.f)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.VAlign(VAlign_Center)
+				.OnClicked(this, &SGridMapEditorSettingsWidget::OnConvertInstancesToTiles)
+				.Text(LOCTEXT("ConvertInstancesToTiles", "Convert To Actors"))
+				.ToolTipText(LOCTEXT("ConvertInstancesToTiles_ToolTip", "Replaces every instanced chunk with individual tile actors so they can be edited"))
+			]
+		]
+		// Variant seed
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		[
+			SNew(SHorizontalBox)
+			.ToolTipText(LOCTEXT("MapSeed_ToolTip", "Seed used to pick between tile variants for this map"))
+
+			+ SHorizontalBox::Slot()
+			.Padding(FGridMapStyleSet::StandardLeftPadding)
+			.FillWidth(1.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(LOCTEXT("MapSeed", "Seed"))
+				.Font(FGridMapStyleSet::StandardFont)
+			]
+
+			+ SHorizontalBox::Slot()
+			.Padding(FGridMapStyleSet::StandardRightPadding)
+			.FillWidth(2.0f)
+			.MaxWidth(100.f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(SNumericEntryBox<int32>)
+				.Font(FGridMapStyleSet::StandardFont)
+				.AllowSpin(false)
+				.MinDesiredValueWidth(50.0f)
+				.Value(this, &SGridMapEditorSettingsWidget::GetMapSeed)
+				.OnValueCommitted(this, &SGridMapEditorSettingsWidget::OnMapSeedCommitted)
+			]
+
+			+ SHorizontalBox::Slot()
+			.Padding(FGridMapStyleSet::StandardRightPadding)
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			[
+				SNew(SButton)
+				.HAlign(HAlign_Center)
+				.VAlign(VAlign_Center)
+				.OnClicked(this, &SGridMapEditorSettingsWidget::OnRerollMapSeed)
+				.Text(LOCTEXT("RerollMapSeed", "Reroll"))
+				.ToolTipText(LOCTEXT("RerollMapSeed_ToolTip", "Picks a new seed and rebuilds all tiles"))
+			]
+		]
+		// Tile labels
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(FGridMapStyleSet::StandardPadding)
+		[
+			SNew(SHorizontalBox)
+			.ToolTipText(LOCTEXT("TileLabels_ToolTip", "How newly placed tiles are named in the outliner, tiles hidden from the outliner aren't named at all"))
+
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			.VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.Text(LOCTEXT("TileLabels", "Tile Labels"))
+				.Font(FGridMapStyleSet::StandardFont)
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(FGridMapStyleSet::StandardRightPadding)
+			[
+				SNew(SCheckBox)
+				.Style(FEditorStyle::Get(), "RadioButton")
+				.IsChecked(this, &SGridMapEditorSettingsWidget::GetCheckState_TileLabelMode, EGridMapTileLabelMode::Cell)
+				.OnCheckStateChanged(this, &SGridMapEditorSettingsWidget::OnCheckStateChanged_TileLabelMode, EGridMapTileLabelMode::Cell)
+				.ToolTipText(LOCTEXT("TileLabels_Cell_ToolTip", "Tile set name and cell, ie. SM_Floor_3_-2_0"))
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("TileLabels_Cell", "Cell"))
+					.Font(FGridMapStyleSet::StandardFont)
+				]
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(FGridMapStyleSet::StandardRightPadding)
+			[
+				SNew(SCheckBox)
+				.Style(FEditorStyle::Get(), "RadioButton")
+				.IsChecked(this, &SGridMapEditorSettingsWidget::GetCheckState_TileLabelMode, EGridMapTileLabelMode::Counter)
+				.OnCheckStateChanged(this, &SGridMapEditorSettingsWidget::OnCheckStateChanged_TileLabelMode, EGridMapTileLabelMode::Counter)
+				.ToolTipText(LOCTEXT("TileLabels_Counter_ToolTip", "Tile set name and a running number, ie. SM_Floor_12"))
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("TileLabels_Counter", "Counter"))
+					.Font(FGridMapStyleSet::StandardFont)
+				]
+			]
+
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(FGridMapStyleSet::StandardRightPadding)
+			[
+				SNew(SCheckBox)
+				.Style(FEditorStyle::Get(), "RadioButton")
+				.IsChecked(this, &SGridMapEditorSettingsWidget::GetCheckState_TileLabelMode, EGridMapTileLabelMode::Unique)
+				.OnCheckStateChanged(this, &SGridMapEditorSettingsWidget::OnCheckStateChanged_TileLabelMode, EGridMapTileLabelMode::Unique)
+				.ToolTipText(LOCTEXT("TileLabels_Unique_ToolTip", "Tile set name made unique against every label in the level, slow once there are a lot of tiles"))
+				[
+					SNew(STextBlock)
+					.Text(LOCTEXT("TileLabels_Unique", "Unique"))
+					.Font(FGridMapStyleSet::StandardFont)
+				]
+			]
+		]
 		// Debug Options
 		+ SVerticalBox::Slot()
 		.AutoHeight()
@@ -122,9 +328,106 @@ ECheckBoxState SGridMapEditorSettingsWidget::GetCheckState_DrawUpdatedTiles() co
 	return ECheckBoxState::Unchecked;
 }
 
+void SGridMapEditorSettingsWidget::OnCheckStateChanged_TileLabelMode(ECheckBoxState InState, EGridMapTileLabelMode TileLabelMode)
+{
+	if (UISettings && InState == ECheckBoxState::Checked)
+	{
+		UISettings->SetTileLabelMode(TileLabelMode);
+	}
+}
+
+ECheckBoxState SGridMapEditorSettingsWidget::GetCheckState_TileLabelMode(EGridMapTileLabelMode TileLabelMode) const
+{
+	if (UISettings && UISettings->GetTileLabelMode() == TileLabelMode)
+		return ECheckBoxState::Checked;
+
+	return ECheckBoxState::Unchecked;
+}
+
 FReply SGridMapEditorSettingsWidget::OnRebuildAllTiles()
 {
-	EditorMode->UpdateAllTiles();
+	EditorMode->RequestUpdateAllTiles();
+	return FReply::Handled();
+}
+
+bool SGridMapEditorSettingsWidget::IsEnabled_RebuildAllTiles() const
+{
+	return !EditorMode->IsUpdatingAllTiles();
+}
+
+EVisibility SGridMapEditorSettingsWidget::GetVisibility_RebuildProgress() const
+{
+	return EditorMode->IsUpdatingAllTiles() ? EVisibility::Visible : EVisibility::Collapsed;
+}
+
+TOptional<float> SGridMapEditorSettingsWidget::GetRebuildProgress() const
+{
+	return EditorMode->GetUpdateAllTilesProgress();
+}
+
+FReply SGridMapEditorSettingsWidget::OnCancelRebuild()
+{
+	EditorMode->CancelUpdateAllTiles();
+	return FReply::Handled();
+}
+
+void SGridMapEditorSettingsWidget::OnCheckStateChanged_TimeSliceRebuilds(ECheckBoxState InState)
+{
+	if (UISettings)
+	{
+		UISettings->SetTimeSliceRebuilds(InState == ECheckBoxState::Checked);
+	}
+}
+
+ECheckBoxState SGridMapEditorSettingsWidget::GetCheckState_TimeSliceRebuilds() const
+{
+	if (UISettings && UISettings->GetTimeSliceRebuilds())
+		return ECheckBoxState::Checked;
+
+	return ECheckBoxState::Unchecked;
+}
+
+TOptional<float> SGridMapEditorSettingsWidget::GetRebuildBudgetMs() const
+{
+	if (UISettings)
+		return UISettings->GetRebuildBudgetMs();
+
+	return TOptional<float>();
+}
+
+void SGridMapEditorSettingsWidget::OnRebuildBudgetMsCommitted(float NewBudgetMs, ETextCommit::Type CommitType)
+{
+	if (UISettings)
+	{
+		UISettings->SetRebuildBudgetMs(NewBudgetMs);
+	}
+}
+
+FReply SGridMapEditorSettingsWidget::OnConvertTilesToInstances()
+{
+	EditorMode->ConvertTilesToInstances();
+	return FReply::Handled();
+}
+
+FReply SGridMapEditorSettingsWidget::OnConvertInstancesToTiles()
+{
+	EditorMode->ConvertInstancesToTiles();
+	return FReply::Handled();
+}
+
+TOptional<int32> SGridMapEditorSettingsWidget::GetMapSeed() const
+{
+	return EditorMode->GetMapSeed();
+}
+
+void SGridMapEditorSettingsWidget::OnMapSeedCommitted(int32 NewSeed, ETextCommit::Type CommitType)
+{
+	EditorMode->SetMapSeed(NewSeed);
+}
+
+FReply SGridMapEditorSettingsWidget::OnRerollMapSeed()
+{
+	EditorMode->SetMapSeed(FMath::Rand());
 	return FReply::Handled();
 }
 
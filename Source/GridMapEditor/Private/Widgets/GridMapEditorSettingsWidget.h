@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GridMapEditorTypes.h"
 #include "Layout/Visibility.h"
 #include "Styling/SlateTypes.h"
 #include "Widgets/DeclarativeSyntaxSupport.h"
@@ -24,7 +25,25 @@ private:
 	void OnCheckStateChanged_DrawUpdatedTiles(ECheckBoxState InState);
 	ECheckBoxState GetCheckState_DrawUpdatedTiles() const;
 
+	void OnCheckStateChanged_TileLabelMode(ECheckBoxState InState, EGridMapTileLabelMode TileLabelMode);
+	ECheckBoxState GetCheckState_TileLabelMode(EGridMapTileLabelMode TileLabelMode) const;
+
 	FReply OnRebuildAllTiles();
+	bool IsEnabled_RebuildAllTiles() const;
+	EVisibility GetVisibility_RebuildProgress() const;
+	TOptional<float> GetRebuildProgress() const;
+	FReply OnCancelRebuild();
+
+	void OnCheckStateChanged_TimeSliceRebuilds(ECheckBoxState InState);
+	ECheckBoxState GetCheckState_TimeSliceRebuilds() const;
+	TOptional<float> GetRebuildBudgetMs() const;
+	void OnRebuildBudgetMsCommitted(float NewBudgetMs, ETextCommit::Type CommitType);
+	FReply OnConvertTilesToInstances();
+	FReply OnConvertInstancesToTiles();
+
+	TOptional<int32> GetMapSeed() const;
+	void OnMapSeedCommitted(int32 NewSeed, ETextCommit::Type CommitType);
+	FReply OnRerollMapSeed();
 
 private:
 	FGridMapEditorMode* EditorMode;
@@ -1,5 +1,6 @@
 #include "Widgets/STileSetPalette.h"
 #include "AssetThumbnail.h"
+#include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "GridMapEditorMode.h"
 #include "Misc/FeedbackContext.h"
 #include "Misc/ScopedSlowTask.h"
@@ -170,7 +171,7 @@ TSharedRef<SWidget> STileSetPalette::BuildPaletteView()
 		.ListItemsSource(&FilteredItems)
 		.SelectionMode(ESelectionMode::Single)
 		.OnGenerateTile(this, &STileSetPalette::GenerateTile)
-		//.OnContextMenuOpening(this, &SFoliagePalette::ConstructFoliageTypeContextMenu)
+		.OnContextMenuOpening(this, &STileSetPalette::ConstructTileSetContextMenu)
 		.OnSelectionChanged(this, &STileSetPalette::OnSelectionChanged)
 		.ItemHeight(64)//this, &SFoliagePalette::GetScaledThumbnailSize)
 		.ItemWidth(64)//this, &SFoliagePalette::GetScaledThumbnailSize)
@@ -184,7 +185,7 @@ TSharedRef<SWidget> STileSetPalette::BuildPaletteView()
 
 TSharedRef<ITableRow> STileSetPalette::GenerateTile(UGridMapTileSet* Item, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	return SNew(STileSetItemTile, OwnerTable, ThumbnailPool, Item);
+	return SNew(STileSetItemTile, OwnerTable, ThumbnailPool, Item, EditorMode);
 
 	// Refresh the palette to ensure that thumbnails are correct
 	RefreshPalette();
@@ -197,6 +198,30 @@ void STileSetPalette::OnSelectionChanged(UGridMapTileSet* Item, ESelectInfo::Typ
 	EditorMode->SetActiveTileSet(Item);	
 }
 
+TSharedPtr<SWidget> STileSetPalette::ConstructTileSetContextMenu()
+{
+	const bool bShouldCloseWindowAfterMenuSelection = true;
+	FMenuBuilder MenuBuilder(bShouldCloseWindowAfterMenuSelection, nullptr);
+
+	MenuBuilder.AddMenuEntry(
+		LOCTEXT("RemoveTileSet", "Remove"),
+		LOCTEXT("RemoveTileSet_ToolTip", "Removes the tile set from the palette, and lets go of its loaded meshes"),
+		FSlateIcon(),
+		FUIAction(FExecuteAction::CreateSP(this, &STileSetPalette::OnRemoveTileSet)));
+
+	return MenuBuilder.MakeWidget();
+}
+
+void STileSetPalette::OnRemoveTileSet()
+{
+	for (UGridMapTileSet* TileSet : TileViewWidget->GetSelectedItems())
+	{
+		EditorMode->RemoveActiveTileSet(TileSet);
+	}
+
+	UpdatePalette(true);
+}
+
 void STileSetPalette::UpdatePalette(bool bRebuildItems)
 {
 	bItemsNeedRebuild |= bRebuildItems;
@@ -30,6 +30,8 @@ private:
 
 	TSharedRef<ITableRow> GenerateTile(UGridMapTileSet* Item, const TSharedRef<STableViewBase>& OwnerTable);
 	void OnSelectionChanged(UGridMapTileSet* Item, ESelectInfo::Type SelectInfo);
+	TSharedPtr<SWidget> ConstructTileSetContextMenu();
+	void OnRemoveTileSet();
 
 	void UpdatePalette(bool bRebuildItems);
 	EActiveTimerReturnType UpdatePaletteItems(double InCurrentTime, float InDeltaTime);
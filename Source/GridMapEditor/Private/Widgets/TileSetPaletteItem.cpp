@@ -2,6 +2,8 @@
 #include "AssetThumbnail.h"
 #include "GridMapEditorMode.h"
 #include "TileSet.h"
+#include "Widgets/Notifications/SProgressBar.h"
+#include "Widgets/SOverlay.h"
 #include "Widgets/STileSetPalette.h"
 
 FTileSetPaletteItemModel::FTileSetPaletteItemModel(UGridMapTileSet* InTileSet, TSharedRef<STileSetPalette> InTileSetPalette, FGridMapEditorMode* InEditorMode)
@@ -12,9 +14,12 @@ FTileSetPaletteItemModel::FTileSetPaletteItemModel(UGridMapTileSet* InTileSet, T
 }
 
 
-void STileSetItemTile::Construct(const FArguments& InArgs, TSharedRef<STableViewBase> InOwnerTableView, TSharedPtr<FAssetThumbnailPool> InThumbnailPool, UGridMapTileSet* TileSet)
+void STileSetItemTile::Construct(const FArguments& InArgs, TSharedRef<STableViewBase> InOwnerTableView, TSharedPtr<FAssetThumbnailPool> InThumbnailPool, UGridMapTileSet* InTileSet, FGridMapEditorMode* InEditorMode)
 {
-	FAssetData AssetData(TileSet);
+	TileSet = InTileSet;
+	EditorMode = InEditorMode;
+
+	FAssetData AssetData(InTileSet);
 	int32 MaxThumbnailSize = 64;
 	TSharedPtr<FAssetThumbnail> Thumbnail = MakeShareable(new FAssetThumbnail(AssetData, MaxThumbnailSize, MaxThumbnailSize, InThumbnailPool));
 
@@ -31,8 +36,31 @@ void STileSetItemTile::Construct(const FArguments& InArgs, TSharedRef<STableView
 			.ForegroundColor(FLinearColor::White)
 			//.ColorAndOpacity(this, &SFoliagePaletteItemTile::GetTileColorAndOpacity)
 			[
-				Thumbnail->MakeThumbnailWidget(ThumbnailConfig)
+				SNew(SOverlay)
+				+ SOverlay::Slot()
+				[
+					Thumbnail->MakeThumbnailWidget(ThumbnailConfig)
+				]
+				// Mesh preload progress
+				+ SOverlay::Slot()
+				.VAlign(VAlign_Bottom)
+				.Padding(2.f)
+				[
+					SNew(SProgressBar)
+					.Visibility(this, &STileSetItemTile::GetVisibility_LoadProgress)
+					.Percent(this, &STileSetItemTile::GetLoadProgress)
+				]
 			]
 		]
 	, InOwnerTableView);
+}
+
+TOptional<float> STileSetItemTile::GetLoadProgress() const
+{
+	return EditorMode->GetTileSetLoadProgress(TileSet.Get());
+}
+
+EVisibility STileSetItemTile::GetVisibility_LoadProgress() const
+{
+	return EditorMode->IsTileSetLoading(TileSet.Get()) ? EVisibility::HitTestInvisible : EVisibility::Collapsed;
 }
\ No newline at end of file
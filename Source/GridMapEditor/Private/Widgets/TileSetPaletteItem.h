@@ -27,5 +27,12 @@ public:
 	SLATE_BEGIN_ARGS(STileSetItemTile) {}
 	SLATE_END_ARGS()
 
-	void Construct(const FArguments& InArgs, TSharedRef<STableViewBase> InOwnerTableView, TSharedPtr<FAssetThumbnailPool> InThumbnailPool, UGridMapTileSet* TileSet);
+	void Construct(const FArguments& InArgs, TSharedRef<STableViewBase> InOwnerTableView, TSharedPtr<FAssetThumbnailPool> InThumbnailPool, UGridMapTileSet* TileSet, FGridMapEditorMode* InEditorMode);
+
+private:
+	TOptional<float> GetLoadProgress() const;
+	EVisibility GetVisibility_LoadProgress() const;
+
+	TWeakObjectPtr<UGridMapTileSet> TileSet;
+	FGridMapEditorMode* EditorMode;
 };
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "PropertyEditorDelegates.h"
 #include "Modules/ModuleManager.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogGridMapEditor, Log, All);
+
 class FGridMapEditorModule : public IModuleInterface
 {
 public:
@@ -18,10 +20,14 @@ public:
 private:
 	void RegisterAssetTypeAction(class IAssetTools& AssetTools, TSharedRef<class IAssetTypeActions> Action);
 	void RegisterCustomPropertyTypeLayout(FName PropertyTypeName, FOnGetPropertyTypeCustomizationInstance PropertyTypeLayoutDelegate);
+	void OnPostEngineInit();
 
 	TSharedPtr<class FSlateStyleSet> StyleSet;
 	TSet<FName> RegisteredPropertyTypes;
 	TArray<TSharedPtr<class IAssetTypeActions>> CreatedAssetTypeActions;
 
 	EAssetTypeCategories::Type GridMapAssetCategory;
+
+	/** Keeps the grid data up to date with tiles edited by hand while the mode isn't active */
+	TUniquePtr<class FGridMapViewSync> ViewSync;
 };